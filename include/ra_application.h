@@ -10,6 +10,7 @@
 
 #include <c_port.h>
 #include <ra_window.h>
+#include <ra_upload.h>
 
 
 enum   RaDpiScalingPolicy  {
@@ -95,6 +96,10 @@ enum RaWindowFlags
      */
     Contextless = 1 << 9,
 
+    /**
+     * No window, draw into an offscreen framebuffer of window_size, see
+     * RaApplication_CreateHeadless.
+     */
     Windowless = 1 << 10
 
 };
@@ -290,11 +295,92 @@ CAPI_STRUCT(RaApplication);
 
 CAPI_FUNC(RaApplication*) RaApplication_Create(int argc, const char **argv);
 
+/**
+ * Creates an application with no window, that draws into an offscreen
+ * framebuffer of width x height pixels.
+ *
+ * No display is needed, on Linux the GL context is a surfaceless EGL
+ * context, so this runs on render nodes with no X server, i.e. with Mesa
+ * llvmpipe on CPU only machines. Its window, from RaApplication_GetWindow,
+ * takes canvases, batches and atlases as usual, and they are drawn the
+ * same way as in a GLFW window. Draw a frame with RaApplication_DrawFrame,
+ * and read it back with RaWindow_ReadPixels. There are no events, the
+ * event functions return immediately.
+ */
+CAPI_FUNC(RaApplication*) RaApplication_CreateHeadless(int argc, const char **argv,
+        int width, int height);
+
+/**
+ * Creates an application from a config, with a GLFW window of the
+ * configured title, size and window flags, or a headless application of
+ * window_size if the Windowless flag is set.
+ */
+CAPI_FUNC(RaApplication*) RaApplication_CreateWithConfig(const struct RaApplicationConfig *conf);
+
+/**
+ * Runs the main loop until the window is closed. A headless application
+ * draws a single frame and returns.
+ */
 CAPI_FUNC(HRESULT) RaApplication_Run(RaApplication *app);
 
+/**
+ * Draws one frame and returns. A GLFW application also processes the
+ * pending events.
+ */
+CAPI_FUNC(HRESULT) RaApplication_DrawFrame(RaApplication *app);
+
+/**
+ * Sets the image displayed in the application window.
+ *
+ * The data is a tightly packed width x height image in one of the
+ * RaPixelFormat layouts. Formats GL reads natively are uploaded as is, gray
+ * formats are expanded to BGRA on the CPU with the fastest SIMD code this
+ * machine supports.
+ *
+ * NV12 and I420 images are not converted on the CPU, each plane is
+ * uploaded to its own texture and the shader converts to RGB using the
+ * color space set with RaApplication_SetYUVColorSpace. With upload
+ * buffers enabled, each plane takes one buffer of the ring.
+ */
 CAPI_FUNC(HRESULT) RaApplication_SetImage(RaApplication* _app, uint32_t width, uint32_t height,
         uint32_t format, const void *data);
 
+/**
+ * Updates a rectangle of the image set with RaApplication_SetImage.
+ *
+ * The source rows are stride bytes apart (0 for tightly packed), so a crop
+ * of a larger frame can be passed by pointing data at the first pixel of
+ * the crop with the stride of the whole frame. For formats GL reads
+ * natively, the stride is given to GL as the unpack row length and the
+ * pixels are read in place, so it must be a multiple of the pixel size.
+ * The region must lie inside the current image, planar YUV formats are not
+ * supported. Fails if the current image is not one set with
+ * RaApplication_SetImage in a non-YUV format, i.e. a YUV image or an asset.
+ */
+CAPI_FUNC(HRESULT) RaApplication_SetImageRegion(RaApplication* app, uint32_t x, uint32_t y,
+        uint32_t width, uint32_t height, uint32_t stride, uint32_t format, const void *data);
+
+/**
+ * Sets the RaYUVColorSpace used to display NV12 and I420 images,
+ * default is RA_YUV_BT601.
+ */
+CAPI_FUNC(HRESULT) RaApplication_SetYUVColorSpace(RaApplication* app, uint32_t colorSpace);
+
+/**
+ * Sets the number of pixel-unpack buffers used by RaApplication_SetImage.
+ *
+ * With count > 0, the image is copied into the next free buffer of a ring,
+ * and transferred to the texture without waiting for the previous frame to
+ * finish with it. With count == 0 (the default), the image is uploaded
+ * synchronously from the caller's memory.
+ */
+CAPI_FUNC(HRESULT) RaApplication_SetUploadBuffers(RaApplication* app, int count);
+
+/**
+ * Gets the upload counters for RaApplication_SetImage.
+ */
+CAPI_FUNC(HRESULT) RaApplication_GetUploadStats(RaApplication* app, struct RaUploadStats *stats);
+
 /**
  * This function processes only those events that are already in the event
  * queue and then returns immediately. Processing events will cause the window
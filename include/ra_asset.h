@@ -0,0 +1,144 @@
+/*
+ * ra_asset.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef INCLUDE_RA_ASSET_H_
+#define INCLUDE_RA_ASSET_H_
+
+#include <c_port.h>
+#include <ra_application.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * An image loaded in the background into a texture of an application.
+ *
+ * Loading returns a handle right away. The file is read and decoded, TGA
+ * or JPEG, on worker threads, then uploaded on the render thread a few
+ * rows at a time, at most the upload budget per frame, so starting an
+ * application, or loading many assets, does not hold up the first frames.
+ *
+ * Radium texture files, .rtex, written by the ra-texconv tool, are already
+ * in the layout GL takes, with their mip levels, and are uploaded straight
+ * from the mapped file with no decoding. They load from the compiled in
+ * resources the same way.
+ */
+CAPI_STRUCT(RaAsset);
+
+enum RaAssetState {
+    /**
+     * being read and decoded
+     */
+    RA_ASSET_LOADING = 0,
+
+    /**
+     * decoded, the size is known, being uploaded across frames
+     */
+    RA_ASSET_UPLOADING,
+
+    /**
+     * the texture is complete
+     */
+    RA_ASSET_READY,
+
+    /**
+     * the asset could not be read or decoded
+     */
+    RA_ASSET_FAILED
+};
+
+/**
+ * called on the render thread once an asset is ready, or failed.
+ */
+typedef void (*RaAssetCallback)(void *user_data, RaAsset *asset, HRESULT result);
+
+/**
+ * Counters of the asset loader of an application.
+ */
+struct RaAssetStats {
+
+    /**
+     * number of assets ready, and failed
+     */
+    uint64_t loaded;
+    uint64_t failed;
+
+    /**
+     * number of bytes of pixels uploaded
+     */
+    uint64_t bytes;
+
+    /**
+     * time the workers spent reading and decoding, and the render thread
+     * spent uploading, in nanoseconds
+     */
+    uint64_t decode_ns;
+    uint64_t upload_ns;
+
+    /**
+     * number of assets not yet ready or failed
+     */
+    int pending;
+};
+
+/**
+ * Starts loading an image file, TGA, JPEG or .rtex, for the application.
+ *
+ * @param callback called once the asset is ready or failed, may be NULL.
+ * @returns a handle with a reference for the caller, give it back with
+ * RaAsset_Release.
+ */
+CAPI_FUNC(RaAsset*) RaAsset_Load(RaApplication *app, const char *path,
+        RaAssetCallback callback, void *user_data);
+
+/**
+ * Starts loading an image compiled into the application's resources, as
+ * RaAsset_Load.
+ */
+CAPI_FUNC(RaAsset*) RaAsset_LoadResource(RaApplication *app, const char *group,
+        const char *name, RaAssetCallback callback, void *user_data);
+
+/**
+ * one of RaAssetState.
+ */
+CAPI_FUNC(int) RaAsset_GetState(RaAsset *asset);
+
+/**
+ * Gets the size of the image, once it is decoded.
+ */
+CAPI_FUNC(HRESULT) RaAsset_GetSize(RaAsset *asset, int *width, int *height);
+
+/**
+ * Blocks until the asset is decoded, and uploads whatever is left of it
+ * right away, regardless of the budget. Call on the render thread.
+ */
+CAPI_FUNC(HRESULT) RaAsset_Wait(RaAsset *asset);
+
+/**
+ * Gives back a reference to an asset, the texture is deleted with the
+ * last one. Call on the render thread.
+ */
+CAPI_FUNC(HRESULT) RaAsset_Release(RaAsset *asset);
+
+/**
+ * Draws an asset as the application's image, as RaApplication_SetImage,
+ * once it is ready. The application keeps a reference until another image
+ * is set.
+ */
+CAPI_FUNC(HRESULT) RaApplication_SetImageAsset(RaApplication *app, RaAsset *asset);
+
+/**
+ * Sets the number of bytes of pixels uploaded per frame, at least a row
+ * of an asset is uploaded each frame, default is 4 MB.
+ */
+CAPI_FUNC(HRESULT) RaAsset_SetUploadBudget(RaApplication *app, size_t bytes);
+
+/**
+ * Gets the counters of the asset loader of the application.
+ */
+CAPI_FUNC(HRESULT) RaAsset_GetStats(RaApplication *app, struct RaAssetStats *stats);
+
+#endif /* INCLUDE_RA_ASSET_H_ */
@@ -0,0 +1,121 @@
+/*
+ * ra_atlas.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef INCLUDE_RA_ATLAS_H_
+#define INCLUDE_RA_ATLAS_H_
+
+#include <cairo.h>
+#include <carbon.h>
+#include <stdint.h>
+#include <ra_window.h>
+
+/**
+ * A texture atlas for small canvases and images, i.e. thumbnails, icons
+ * and labels.
+ *
+ * Items of any size up to the page size are packed into shared pages,
+ * which are the layers of one texture array, so thousands of items cost
+ * a handful of textures instead of one each. The atlas draws all of its
+ * visible items in one instanced call, grouped by page, each with its
+ * own transform, same as a RaCanvasBatch.
+ *
+ * Each item has a cairo surface covering just its rectangle of the page.
+ * Removing items leaves holes that later items reuse, and an item that
+ * does not fit in any hole goes on a new page. Items only ever move when
+ * RaAtlas_Defragment is called, which replaces their surfaces and cairo
+ * objects, so get them again after it. Compare RaAtlasStats.used_pixels
+ * with page_pixels to decide when to call it.
+ */
+CAPI_STRUCT(RaAtlas);
+
+typedef struct RaAtlasStats {
+    uint32_t pages;
+    uint32_t items;
+
+    /**
+     * pixels used by items, and total pixels in all pages
+     */
+    uint64_t used_pixels;
+    uint64_t page_pixels;
+
+    /**
+     * times the pages were repacked
+     */
+    uint64_t defragments;
+
+    /**
+     * pixels uploaded to the pages
+     */
+    uint64_t upload_bytes;
+} RaAtlasStats;
+
+/**
+ * Creates an atlas with square pages of page_size pixels, and attaches it
+ * to a window, which draws it after its canvas and batches.
+ */
+CAPI_FUNC(RaAtlas*) RaAtlas_Create(RaWindow *win, int page_size);
+
+CAPI_FUNC(HRESULT) RaAtlas_Destroy(RaAtlas *atlas);
+
+/**
+ * Adds a cleared item of width x height pixels, visible, with the
+ * identity transform.
+ *
+ * Existing items are never moved, if the new one does not fit in the
+ * pages, a page is added.
+ *
+ * @returns the id of the item, or -1 if it is larger than a page or the
+ * maximum number of pages is reached.
+ */
+CAPI_FUNC(int) RaAtlas_Add(RaAtlas *atlas, int width, int height);
+
+/**
+ * Removes an item, its space in the page is reused by later items.
+ */
+CAPI_FUNC(HRESULT) RaAtlas_Remove(RaAtlas *atlas, int id);
+
+/**
+ * Gets the surface of an item, the size of the item, drawing outside of
+ * it is clipped.
+ */
+CAPI_FUNC(cairo_surface_t*) RaAtlas_Surface(RaAtlas *atlas, int id);
+
+CAPI_FUNC(cairo_t*) RaAtlas_Cairo(RaAtlas *atlas, int id);
+
+/**
+ * Copies pixels into an item, in the cairo ARGB32 layout, BGRA byte order
+ * with premultiplied alpha, rows are stride bytes apart. The item is
+ * marked dirty.
+ */
+CAPI_FUNC(HRESULT) RaAtlas_SetPixels(RaAtlas *atlas, int id, const void *data, int stride);
+
+/**
+ * Marks an item as changed, it is uploaded on the next flush.
+ */
+CAPI_FUNC(HRESULT) RaAtlas_MarkDirty(RaAtlas *atlas, int id);
+
+/**
+ * Sets the transform of an item, a column major 4x4 matrix taking the
+ * item quad, from (-1, -1) to (1, 1), to clip space.
+ */
+CAPI_FUNC(HRESULT) RaAtlas_SetTransform(RaAtlas *atlas, int id, const float *matrix);
+
+CAPI_FUNC(HRESULT) RaAtlas_SetVisible(RaAtlas *atlas, int id, int visible);
+
+/**
+ * Uploads the changed items to their pages.
+ */
+CAPI_FUNC(HRESULT) RaAtlas_Flush(RaAtlas *atlas);
+
+/**
+ * Repacks all the items, tallest first, into as few pages as possible.
+ */
+CAPI_FUNC(HRESULT) RaAtlas_Defragment(RaAtlas *atlas);
+
+CAPI_FUNC(HRESULT) RaAtlas_GetStats(RaAtlas *atlas, RaAtlasStats *stats);
+
+#endif /* INCLUDE_RA_ATLAS_H_ */
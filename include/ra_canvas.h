@@ -11,6 +11,8 @@
 #include <cairo.h>
 #include <carbon.h>
 #include <ra_window.h>
+#include <ra_upload.h>
+#include <ra_fence.h>
 
 /**
  * The canvas represents a 2D surface that's free to move around in 3D space.
@@ -21,29 +23,301 @@
 
 CAPI_STRUCT(RaCanvas);
 
+/**
+ * Canvas creation flags
+ */
+enum RaCanvasFlags {
+
+    /**
+     * Cairo draws directly into persistently mapped GL buffers, so flushing
+     * does not copy the pixels on the CPU. The canvas cycles through three
+     * buffers, so like a swap chain, the surface does not keep its contents
+     * across a flush, and every frame must be completely redrawn. The
+     * surface and cairo object also change with every flush, get them again
+     * with RaCanvas_Surface and RaCanvas_Cairo after flushing.
+     *
+     * Requires GL 4.4 or ARB_buffer_storage, a regular canvas is created
+     * if not supported.
+     */
+    RA_CANVAS_PERSISTENT = 1 << 0,
+
+    /**
+     * Drawing commands are recorded, and rasterized in parallel on flush.
+     * The surface is split in tiles, and each tile the frame touched
+     * replays the recording on a worker thread, flush returns once all the
+     * tiles are done. What the frame touched is also marked dirty, so with
+     * damage tracking only those regions are uploaded.
+     *
+     * The cairo object draws into the recording, not the surface, and is
+     * destroyed and replaced by a fresh one on each flush, so get it again
+     * with RaCanvas_Cairo after flushing, and never keep it across one.
+     * Each frame is composited OVER the previous one as a whole, so only
+     * draw with the OVER operator: CLEAR, SOURCE and the like only act on
+     * what the same frame drew, not on the pixels of earlier frames.
+     */
+    RA_CANVAS_TILED = 1 << 1,
+
+    /**
+     * The canvas texture has a full mip chain, and is sampled with
+     * trilinear filtering, for canvases shown minified in 3D. Flush only
+     * filters and uploads the parts of each mip level under the dirty
+     * regions, on the CPU, never the whole chain. Layers of the canvas are
+     * mipmapped too. Ignored for persistent canvases, which are not read
+     * back on the CPU.
+     */
+    RA_CANVAS_MIPMAPPED = 1 << 2,
+
+    /**
+     * The canvas is drawn by a producer thread, and uploaded on the GL
+     * thread, without either ever waiting for the other.
+     *
+     * The canvas has three surfaces. The producer draws a frame with the
+     * surface and cairo object from RaCanvas_Surface and RaCanvas_Cairo,
+     * then calls RaCanvas_Publish. When the window is drawn, the most
+     * recent published frame is uploaded, frames published in between are
+     * skipped. Like a persistent canvas, each publish moves the producer
+     * to another surface, so get the cairo object again after publishing,
+     * and completely redraw every frame.
+     *
+     * Replaces the persistent and tiled modes. RaCanvas_Flush only flushes
+     * the layers of a threaded canvas, and the canvas is never resized with
+     * the window, resize or destroy it only while the producer is stopped.
+     * The window redraws continuously while it has a threaded canvas.
+     */
+    RA_CANVAS_THREADED = 1 << 3,
+
+    /**
+     * The window resizes the canvas to its framebuffer, with
+     * RaCanvas_Resize, whenever the framebuffer size changes. The surface
+     * and cairo object are then replaced from within the window's event
+     * processing, so get them again for every frame. Ignored for threaded
+     * canvases.
+     */
+    RA_CANVAS_RESIZE_WITH_WINDOW = 1 << 4
+};
+
 /**
  * Creates a canvas and attaches it to a window.
  */
 CAPI_FUNC(RaCanvas*) RaCanvas_CreateForWindow(RaWindow *win);
 
+/**
+ * Creates a canvas with a set of RaCanvasFlags, and attaches it to a window.
+ */
+CAPI_FUNC(RaCanvas*) RaCanvas_CreateForWindowWithFlags(RaWindow *win, uint32_t flags);
+
+/**
+ * Destroys a canvas, and detaches it from its window.
+ *
+ * The surface memory and texture go back to a pool shared by all
+ * canvases, so creating a canvas of about the same size again, i.e. for
+ * popups, does not allocate.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_Destroy(RaCanvas *canvas);
+
+/**
+ * Changes the size of a canvas, and all its layers, in pixels.
+ *
+ * The canvas is cleared, and the surfaces and cairo objects are replaced,
+ * so get them again with RaCanvas_Surface and RaCanvas_Cairo afterwards.
+ * Storage comes from the pool, in buckets rounded up to a multiple of 128
+ * pixels, so during an interactive resize most sizes reuse the same
+ * memory and texture. Canvases keep their size when the window is
+ * resized, unless created with RA_CANVAS_RESIZE_WITH_WINDOW.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_Resize(RaCanvas *canvas, int width, int height);
+
+/**
+ * Frees the idle surface memory kept in the pool, and the idle textures
+ * of the current GL context, textures are pooled per context.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_TrimPool();
+
 /**
  * Gets the cairo surface for this canvas.
+ *
+ * For persistent canvases, the surface changes after each flush.
  */
 CAPI_FUNC(cairo_surface_t*) RaCanvas_Surface(RaCanvas *canvas);
 
 /**
  * Gets the cairo object for the surface in this canvas.
+ *
+ * For persistent or tiled canvases, the cairo object changes after each
+ * flush, the one from before the flush is destroyed, and must not be used
+ * any more.
  */
 CAPI_FUNC(cairo_t*) RaCanvas_Cairo(RaCanvas *canvas);
 
+/**
+ * Publishes the frame drawn by the producer thread of a threaded canvas,
+ * it is uploaded the next time the window is drawn. Only call from the
+ * producer thread, never blocks.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_Publish(RaCanvas *canvas);
+
 /**
  * Flushes all drawing commands from cairo, and copies the drawn image
  * to the texture.
  *
+ * If any regions were marked with RaCanvas_MarkDirty since the last
+ * flush, only those regions are copied, otherwise the whole surface is.
+ *
  * Use this instead of  cairo_surface_flush(surface);
  */
 CAPI_FUNC(HRESULT) RaCanvas_Flush(RaCanvas *canvas);
 
+/**
+ * Flushes the canvas like RaCanvas_Flush, and returns a fence that is
+ * signaled once the GPU has consumed the uploaded pixels, so the caller
+ * can rasterize the next frame while this one is transferred, and know
+ * when buffers the upload reads from, i.e. persistent surfaces, are free.
+ *
+ * If callback is not NULL, it is called with user_data on the GL thread
+ * once the upload is done, from a later flush or draw of the canvas, or
+ * when the canvas is destroyed.
+ *
+ * @returns a fence to release with RaFence_Destroy, NULL on error.
+ */
+CAPI_FUNC(RaFence*) RaCanvas_FlushAsync(RaCanvas *canvas, RaFenceCallback callback,
+        void *user_data);
+
+/**
+ * Marks a rectangle of the canvas, in surface pixel coordinates, as changed.
+ *
+ * Once a canvas has had a region marked dirty, it switches to damage
+ * tracking, and RaCanvas_Flush only uploads the marked regions, merging
+ * overlapping regions. Anything drawn outside a marked region is not
+ * copied to the texture until that region is marked.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_MarkDirty(RaCanvas *canvas, int x, int y, int w, int h);
+
+/**
+ * Marks the entire canvas as changed, the next flush uploads everything.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_MarkAllDirty(RaCanvas *canvas);
+
+/**
+ * Adds a layer on top of the canvas.
+ *
+ * Each layer has its own surface and texture, starts out transparent, and
+ * is alpha blended over the layers below it when the canvas is drawn. The
+ * base surface of the canvas is layer 0 and is drawn opaque.
+ *
+ * RaCanvas_Flush only uploads layers that were invalidated or had regions
+ * marked dirty since the last flush, so i.e. a static background and a
+ * fast changing overlay do not cost each other uploads. Layers are always
+ * regular image surfaces, the canvas creation flags apply to the base only.
+ *
+ * @returns the index of the new layer, or -1 on error.
+ */
+CAPI_FUNC(int) RaCanvas_AddLayer(RaCanvas *canvas);
+
+/**
+ * Number of layers, including the base.
+ */
+CAPI_FUNC(int) RaCanvas_LayerCount(RaCanvas *canvas);
+
+/**
+ * Gets the cairo surface of a layer, layer 0 is the base surface.
+ */
+CAPI_FUNC(cairo_surface_t*) RaCanvas_LayerSurface(RaCanvas *canvas, int layer);
+
+/**
+ * Gets the cairo object of a layer, layer 0 is the base surface.
+ */
+CAPI_FUNC(cairo_t*) RaCanvas_LayerCairo(RaCanvas *canvas, int layer);
+
+/**
+ * Marks the whole layer as changed, it is uploaded on the next flush.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_InvalidateLayer(RaCanvas *canvas, int layer);
+
+/**
+ * Marks a rectangle of a layer as changed, same as RaCanvas_MarkDirty for
+ * the layer. Only the marked regions are uploaded on the next flush.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_MarkLayerDirty(RaCanvas *canvas, int layer,
+        int x, int y, int w, int h);
+
+/**
+ * Shows or hides a layer, the base layer is always visible.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_SetLayerVisible(RaCanvas *canvas, int layer, int visible);
+
+/**
+ * Starts a block of drawing whose rasterized result is cached under key.
+ *
+ * Use this for content that is the same from frame to frame, like axes,
+ * grids or legends:
+ *
+ *     cairo_t *cr = RaCanvas_BeginCached(canvas, AXES);
+ *     if(cr) {
+ *         draw_axes(cr);
+ *     }
+ *     RaCanvas_EndCached(canvas, AXES);
+ *
+ * If the key has no cached raster, or the canvas size or the current
+ * transform of the canvas cairo object changed since it was made, returns
+ * a cairo object that records the block, with the canvas transform
+ * already set. Otherwise returns NULL, and the drawing can be skipped.
+ * Blocks can not be nested.
+ */
+CAPI_FUNC(cairo_t*) RaCanvas_BeginCached(RaCanvas *canvas, uint64_t key);
+
+/**
+ * Ends a block started with RaCanvas_BeginCached. If the block was
+ * recorded, it is rasterized and kept. Either way, the cached raster is
+ * then painted onto the canvas.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_EndCached(RaCanvas *canvas, uint64_t key);
+
+/**
+ * Drops the cached raster for key, the next RaCanvas_BeginCached with
+ * that key records again. Use when the content itself changes.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_InvalidateCached(RaCanvas *canvas, uint64_t key);
+
+/**
+ * Drops all the cached rasters of the canvas.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_ClearCache(RaCanvas *canvas);
+
+/**
+ * Sets the number of pixel-unpack buffers used to upload the canvas.
+ *
+ * With count > 0, flush copies the changed pixels into the next free
+ * buffer of a ring and starts a non-blocking transfer to the texture,
+ * instead of uploading straight from the surface memory. Two or three
+ * buffers are usually enough, starved uploads show up in the upload stats.
+ *
+ * With count == 0 (the default), flush uploads synchronously.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_SetUploadBuffers(RaCanvas *canvas, int count);
+
+/**
+ * Enables content hashing of the canvas surface on flush.
+ *
+ * The surface is split into tile_size x tile_size tiles, and each tile is
+ * hashed on flush and compared with its hash from the last flush. Only the
+ * tiles that changed are uploaded, whether or not they were marked dirty,
+ * so drawing that never reports what it changed still costs only what it
+ * actually changed. Marked dirty regions, if any, limit which tiles are
+ * hashed. Unchanged bytes show up as skipped_bytes in the upload stats.
+ *
+ * Hashing reads the whole surface, or the marked regions, on every flush,
+ * which is much cheaper than uploading them, but not free. 64 is a good
+ * tile size. Persistent and threaded canvases are not hashed.
+ *
+ * With tile_size == 0 (the default), hashing is disabled.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_SetContentHashing(RaCanvas *canvas, int tile_size);
+
+/**
+ * Gets the upload counters for this canvas.
+ */
+CAPI_FUNC(HRESULT) RaCanvas_GetUploadStats(RaCanvas *canvas, struct RaUploadStats *stats);
+
 
 
 #endif /* INCLUDE_RA_CANVAS_H_ */
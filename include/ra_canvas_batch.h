@@ -0,0 +1,98 @@
+/*
+ * ra_canvas_batch.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef INCLUDE_RA_CANVAS_BATCH_H_
+#define INCLUDE_RA_CANVAS_BATCH_H_
+
+#include <cairo.h>
+#include <carbon.h>
+#include <ra_window.h>
+#include <ra_upload.h>
+
+/**
+ * A batch of canvases of the same size, drawn all at once.
+ *
+ * Each canvas in the batch is a cairo image surface, same as a RaCanvas,
+ * but instead of each having its own texture, program and draw call, the
+ * batch keeps them in the layers of one texture array, and draws every
+ * visible canvas in a single instanced draw, each with its own transform.
+ * Use this for large numbers of panels or labels.
+ *
+ * Canvases are identified by an index, which stays the same until the
+ * canvas is removed, indices of removed canvases are reused.
+ */
+CAPI_STRUCT(RaCanvasBatch);
+
+/**
+ * Creates a batch of canvases of width x height pixels, and attaches it
+ * to a window, which draws it after its own canvas.
+ */
+CAPI_FUNC(RaCanvasBatch*) RaCanvasBatch_Create(RaWindow *win, int width, int height);
+
+/**
+ * Destroys the batch and all of its canvases.
+ */
+CAPI_FUNC(HRESULT) RaCanvasBatch_Destroy(RaCanvasBatch *batch);
+
+/**
+ * Adds a cleared canvas to the batch, visible, with the identity
+ * transform, which covers the whole viewport.
+ *
+ * The texture array grows as needed, up to the GL limit on array layers.
+ *
+ * @returns the index of the canvas, or -1 on error.
+ */
+CAPI_FUNC(int) RaCanvasBatch_Add(RaCanvasBatch *batch);
+
+/**
+ * Removes a canvas, its index can be reused by a later RaCanvasBatch_Add.
+ */
+CAPI_FUNC(HRESULT) RaCanvasBatch_Remove(RaCanvasBatch *batch, int index);
+
+/**
+ * Number of canvases in the batch.
+ */
+CAPI_FUNC(int) RaCanvasBatch_Count(RaCanvasBatch *batch);
+
+CAPI_FUNC(cairo_surface_t*) RaCanvasBatch_Surface(RaCanvasBatch *batch, int index);
+
+CAPI_FUNC(cairo_t*) RaCanvasBatch_Cairo(RaCanvasBatch *batch, int index);
+
+/**
+ * Sets the transform of a canvas, a column major 4x4 matrix taking the
+ * canvas quad, from (-1, -1) to (1, 1), to clip space.
+ */
+CAPI_FUNC(HRESULT) RaCanvasBatch_SetTransform(RaCanvasBatch *batch, int index,
+        const float *matrix);
+
+CAPI_FUNC(HRESULT) RaCanvasBatch_SetVisible(RaCanvasBatch *batch, int index, int visible);
+
+/**
+ * Marks a rectangle of a canvas as changed, it is uploaded on the next
+ * flush.
+ */
+CAPI_FUNC(HRESULT) RaCanvasBatch_MarkDirty(RaCanvasBatch *batch, int index,
+        int x, int y, int w, int h);
+
+/**
+ * Marks a whole canvas as changed.
+ */
+CAPI_FUNC(HRESULT) RaCanvasBatch_Invalidate(RaCanvasBatch *batch, int index);
+
+/**
+ * Flushes the drawing commands of the changed canvases, and uploads the
+ * regions marked dirty to their layers of the texture array. Canvases that
+ * were not marked since the last flush are not touched.
+ */
+CAPI_FUNC(HRESULT) RaCanvasBatch_Flush(RaCanvasBatch *batch);
+
+/**
+ * Counts of the layer uploads done by the batch.
+ */
+CAPI_FUNC(HRESULT) RaCanvasBatch_GetUploadStats(RaCanvasBatch *batch, RaUploadStats *stats);
+
+#endif /* INCLUDE_RA_CANVAS_BATCH_H_ */
@@ -0,0 +1,172 @@
+/*
+ * ra_capture.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef INCLUDE_RA_CAPTURE_H_
+#define INCLUDE_RA_CAPTURE_H_
+
+#include <c_port.h>
+#include <ra_window.h>
+#include <stdint.h>
+
+/**
+ * Records the frames drawn in a window, to a motion-JPEG AVI or to a
+ * numbered sequence of JPEG files.
+ *
+ * Once started, every frame drawn in the window, or every Nth one, is read
+ * back with RaWindow_ReadPixelsAsync, encoded on worker threads, and written
+ * to disk on a writer thread. At most ring_size raw frames, and as many
+ * encoded ones waiting for the disk, are held in memory. When the ring is
+ * full, the frame is dropped or the render thread waits, as set by the
+ * policy, and the time the render thread spends on capture is counted so
+ * it can be compared with the frame time.
+ */
+CAPI_STRUCT(RaCapture);
+
+enum RaCaptureFormat {
+    /**
+     * a single AVI file of JPEG frames. AVI 1.0 files are limited to 4 GB,
+     * frames past that are dropped.
+     */
+    RA_CAPTURE_MJPEG_AVI = 0,
+
+    /**
+     * a JPEG file per frame, path has a single %d or %0Nd conversion for
+     * the frame number, i.e. "frame%05d.jpg", and %% for a literal %.
+     */
+    RA_CAPTURE_JPEG_SEQUENCE = 1
+};
+
+enum RaCapturePolicy {
+    /**
+     * skip frames while the ring is full, the render thread never waits
+     * for the encoders or the disk.
+     */
+    RA_CAPTURE_DROP = 0,
+
+    /**
+     * wait for room in the ring, every frame is recorded, but a slow disk
+     * slows down rendering.
+     */
+    RA_CAPTURE_THROTTLE = 1
+};
+
+struct RaCaptureConfig {
+
+    /**
+     * one of RaCaptureFormat
+     */
+    uint32_t format;
+
+    /**
+     * the AVI file, or the file name pattern of a sequence.
+     */
+    const char *path;
+
+    /**
+     * record every Nth frame, 0 or 1 for every frame.
+     */
+    int every;
+
+    /**
+     * one of RaCapturePolicy
+     */
+    uint32_t policy;
+
+    /**
+     * max number of frames in memory, 0 for 8.
+     */
+    int ring_size;
+
+    /**
+     * number of encoder threads, 0 for one per core.
+     */
+    int threads;
+
+    /**
+     * JPEG quality, 1 to 100, 0 for 90.
+     */
+    int quality;
+
+    /**
+     * frame rate written to the AVI header, 0 for 30.
+     */
+    double fps;
+};
+
+/**
+ * Counters of a capture.
+ */
+struct RaCaptureStats {
+
+    /**
+     * number of frames drawn while capturing
+     */
+    uint64_t frames;
+
+    /**
+     * number of frames read back to be recorded
+     */
+    uint64_t captured;
+
+    /**
+     * number of frames skipped because the ring was full, or the file could
+     * not take them
+     */
+    uint64_t dropped;
+
+    /**
+     * number of frames the render thread waited for room, with
+     * RA_CAPTURE_THROTTLE
+     */
+    uint64_t throttled;
+
+    /**
+     * number of frames and bytes written to disk
+     */
+    uint64_t written;
+    uint64_t bytes;
+
+    /**
+     * time the render thread spent on capture, reading back frames,
+     * copying them out, and waiting, and the total time between the frames
+     * drawn, in nanoseconds
+     */
+    uint64_t capture_ns;
+    uint64_t frame_ns;
+
+    /**
+     * capture_ns / frame_ns, the part of the frame budget capture costs
+     */
+    float budget;
+
+    /**
+     * number of frames read back, encoded or waiting to be written now
+     */
+    int pending;
+};
+
+/**
+ * Starts recording the frames drawn in a window, a window has at most one
+ * capture at a time.
+ *
+ * Frames are captured at the end of drawing the window, so must be started
+ * and stopped on the thread of the window's GL context.
+ */
+CAPI_FUNC(RaCapture*) RaCapture_Start(RaWindow *window, const struct RaCaptureConfig *config);
+
+/**
+ * Stops recording, writes the frames still in flight, finishes the file,
+ * and destroys the capture.
+ */
+CAPI_FUNC(HRESULT) RaCapture_Stop(RaCapture *capture);
+
+/**
+ * Gets the counters of a capture.
+ */
+CAPI_FUNC(HRESULT) RaCapture_GetStats(RaCapture *capture, struct RaCaptureStats *stats);
+
+#endif /* INCLUDE_RA_CAPTURE_H_ */
@@ -0,0 +1,48 @@
+/*
+ * ra_fence.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef INCLUDE_RA_FENCE_H_
+#define INCLUDE_RA_FENCE_H_
+
+#include <c_port.h>
+#include <stdint.h>
+
+/**
+ * A GPU fence, signaled once the GPU has executed every command issued
+ * before the fence was made, i.e. finished reading the pixels of an
+ * upload.
+ *
+ * Fences wrap GL sync objects, so like all GL calls, they must only be
+ * used on the thread of the window's context.
+ */
+CAPI_STRUCT(RaFence);
+
+/**
+ * called once a fence is signaled
+ */
+typedef void (*RaFenceCallback)(void *user_data);
+
+/**
+ * checks a fence without blocking.
+ *
+ * @returns 1 if signaled, 0 if not.
+ */
+CAPI_FUNC(int) RaFence_IsSignaled(RaFence *fence);
+
+/**
+ * blocks until a fence is signaled, or timeout nanoseconds pass.
+ *
+ * @returns 1 if signaled, 0 if the wait timed out.
+ */
+CAPI_FUNC(int) RaFence_Wait(RaFence *fence, uint64_t timeout);
+
+/**
+ * releases a fence, does not wait for it.
+ */
+CAPI_FUNC(HRESULT) RaFence_Destroy(RaFence *fence);
+
+#endif /* INCLUDE_RA_FENCE_H_ */
@@ -0,0 +1,143 @@
+/*
+ * ra_jpeg.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef INCLUDE_RA_JPEG_H_
+#define INCLUDE_RA_JPEG_H_
+
+#include <c_port.h>
+#include <ra_canvas.h>
+#include <ra_window.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Encodes frames to JPEG on a pool of worker threads.
+ *
+ * The caller's pixels are copied into a frame buffer of the encoder, and
+ * the frame is queued, so the render thread only pays for the copy. Each
+ * worker keeps its libjpeg state and scratch rows between frames. With
+ * libjpeg-turbo, BGRA and RGBA rows are passed to libjpeg directly,
+ * otherwise they are converted to RGB with SIMD code.
+ *
+ * The number of frames queued or being encoded is bounded: when it is
+ * reached, encoding a new frame blocks until a worker is done with one.
+ */
+CAPI_STRUCT(RaJpegEncoder);
+
+enum RaJpegFlags {
+    /**
+     * the pixels have premultiplied alpha, as cairo surfaces, and are
+     * un-premultiplied before the alpha is dropped. Without this flag,
+     * the alpha is just dropped, which for premultiplied pixels is the
+     * same as compositing over black.
+     */
+    RA_JPEG_UNPREMULTIPLY = 1 << 0
+};
+
+/**
+ * called on a worker thread once a frame is encoded in memory. The data
+ * is only valid during the call. On failure, data is NULL and size 0.
+ */
+typedef void (*RaJpegCallback)(void *user_data, HRESULT result, const void *data, size_t size);
+
+/**
+ * Counters of a JPEG encoder.
+ */
+struct RaJpegStats {
+
+    /**
+     * number of frames encoded, and failed
+     */
+    uint64_t frames;
+    uint64_t failed;
+
+    /**
+     * number of bytes of JPEG written
+     */
+    uint64_t bytes;
+
+    /**
+     * number of times a caller had to wait because the queue was full, if
+     * this keeps growing, frames come faster than the workers encode them.
+     */
+    uint64_t waits;
+
+    /**
+     * total time the workers spent encoding, in nanoseconds
+     */
+    uint64_t encode_ns;
+
+    /**
+     * number of frames queued or being encoded right now
+     */
+    int queued;
+};
+
+/**
+ * Creates an encoder.
+ *
+ * @param threads number of worker threads, 0 for one per core.
+ * @param queue_size max number of frames queued or being encoded, 0 for
+ * twice the number of threads. Each one holds a copy of a frame.
+ * @param quality JPEG quality, 1 to 100.
+ */
+CAPI_FUNC(RaJpegEncoder*) RaJpegEncoder_Create(int threads, int queue_size, int quality);
+
+/**
+ * Encodes the queued frames, and destroys the encoder.
+ */
+CAPI_FUNC(HRESULT) RaJpegEncoder_Destroy(RaJpegEncoder *encoder);
+
+/**
+ * Queues a frame to be encoded to a JPEG file.
+ *
+ * The pixels are width x height pixels of RA_PIXEL_BGRA8 or RA_PIXEL_RGBA8,
+ * rows stride bytes apart (0 for tightly packed), and are copied before
+ * this returns. flags are RaJpegFlags.
+ */
+CAPI_FUNC(HRESULT) RaJpegEncoder_EncodeFile(RaJpegEncoder *encoder, const void *pixels,
+        int width, int height, int stride, uint32_t format, uint32_t flags, const char *path);
+
+/**
+ * Queues a frame to be encoded in memory, the JPEG is given to callback.
+ * Arguments are as RaJpegEncoder_EncodeFile.
+ */
+CAPI_FUNC(HRESULT) RaJpegEncoder_Encode(RaJpegEncoder *encoder, const void *pixels,
+        int width, int height, int stride, uint32_t format, uint32_t flags,
+        RaJpegCallback callback, void *user_data);
+
+/**
+ * Queues the current content of a canvas surface to be encoded to a JPEG
+ * file, un-premultiplied. For a threaded canvas, this is the frame last
+ * shown, so call it on the GL thread.
+ */
+CAPI_FUNC(HRESULT) RaJpegEncoder_EncodeCanvas(RaJpegEncoder *encoder, RaCanvas *canvas,
+        const char *path);
+
+/**
+ * Reads back what was last drawn in a window with RaWindow_ReadPixelsAsync,
+ * and queues it to be encoded to a JPEG file once the read is delivered,
+ * so neither the read nor the encoding holds up the render thread.
+ */
+CAPI_FUNC(HRESULT) RaJpegEncoder_EncodeWindow(RaJpegEncoder *encoder, RaWindow *window,
+        const char *path);
+
+/**
+ * Blocks until every queued frame is encoded. Reads of
+ * RaJpegEncoder_EncodeWindow still in flight are delivered first, so if
+ * windows were encoded, call this, and RaJpegEncoder_Destroy, on the
+ * thread of the window's GL context. Reads of a GLFW window waiting for a
+ * frame that can not be drawn, i.e. called while it is drawn, are dropped.
+ */
+CAPI_FUNC(HRESULT) RaJpegEncoder_Finish(RaJpegEncoder *encoder);
+
+/**
+ * Gets the counters of the encoder.
+ */
+CAPI_FUNC(HRESULT) RaJpegEncoder_GetStats(RaJpegEncoder *encoder, struct RaJpegStats *stats);
+
+#endif /* INCLUDE_RA_JPEG_H_ */
@@ -0,0 +1,69 @@
+/*
+ * ra_program_cache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef INCLUDE_RA_PROGRAM_CACHE_H_
+#define INCLUDE_RA_PROGRAM_CACHE_H_
+
+#include <c_port.h>
+#include <stdint.h>
+
+/**
+ * On disk cache of linked shader programs.
+ *
+ * The first launch compiles and links the shaders from source, and saves
+ * the driver's binary of each program. Later launches load the binaries
+ * instead. Binaries are keyed by a hash of the shader sources, and the GL
+ * vendor, renderer and version strings, so a driver update or another
+ * GPU never gets a stale binary. A binary the driver still rejects is
+ * deleted, and the program is compiled from source again.
+ *
+ * The cache is in the user's cache directory, in radium/shaders, or in the
+ * directory in the RADIUM_SHADER_CACHE environment variable, an empty
+ * variable disables it. Drivers without ARB_get_program_binary, or that
+ * have no binary formats, always compile.
+ */
+
+/**
+ * Counters of the program cache, since the start of the process.
+ */
+struct RaProgramCacheStats {
+
+    /**
+     * number of programs loaded from a binary, and compiled from source
+     */
+    uint32_t hits;
+    uint32_t misses;
+
+    /**
+     * number of binaries the driver rejected, and binaries saved
+     */
+    uint32_t rejected;
+    uint32_t stored;
+
+    /**
+     * time spent loading binaries, and compiling and linking from source,
+     * in nanoseconds. Compare the two between a cold and a warm launch.
+     */
+    uint64_t load_ns;
+    uint64_t compile_ns;
+};
+
+/**
+ * sets the directory the binaries are kept in, created if needed, NULL
+ * or an empty path disables the cache. Programs are built when the
+ * application is created, so set it before.
+ */
+CAPI_FUNC(HRESULT) RaProgramCache_SetDirectory(const char *path);
+
+/**
+ * deletes all the binaries in the cache directory.
+ */
+CAPI_FUNC(HRESULT) RaProgramCache_Clear();
+
+CAPI_FUNC(HRESULT) RaProgramCache_GetStats(struct RaProgramCacheStats *stats);
+
+#endif /* INCLUDE_RA_PROGRAM_CACHE_H_ */
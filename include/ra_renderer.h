@@ -8,8 +8,58 @@
 #ifndef INCLUDE_RA_RENDERER_H_
 #define INCLUDE_RA_RENDERER_H_
 
+#include <c_port.h>
+#include <stdint.h>
+
 class ra_renderer
 {
 };
 
+/**
+ * GL state changes the renderer asked for in a frame.
+ *
+ * For each kind of state, the number of requests that changed it from
+ * what the renderer last asked for, and the number that asked for the
+ * same again. These are radium level requests, not GL calls: programs,
+ * textures and meshes are all passed on to Magnum, which skips the binds
+ * that are already current on its own, so the _elided counts show how
+ * often the draw path repeats itself, not calls saved here. Blending is
+ * the only state the renderer filters itself, blends_elided are GL calls
+ * that were not made.
+ *
+ * What the renderer last asked for is forgotten at the start of each
+ * frame, and whenever user callbacks run, as they may change the state
+ * behind the renderer's back.
+ */
+struct RaRenderStats {
+
+    /**
+     * number of draw calls
+     */
+    uint32_t draws;
+
+    uint32_t programs;
+    uint32_t programs_elided;
+
+    uint32_t textures;
+    uint32_t textures_elided;
+
+    /**
+     * vertex array binds
+     */
+    uint32_t meshes;
+    uint32_t meshes_elided;
+
+    /**
+     * blending enables, disables and blend function changes
+     */
+    uint32_t blends;
+    uint32_t blends_elided;
+};
+
+/**
+ * counters of the last complete frame drawn in the current GL context.
+ */
+CAPI_FUNC(HRESULT) RaRenderer_GetStats(struct RaRenderStats *stats);
+
 #endif /* INCLUDE_RA_RENDERER_H_ */
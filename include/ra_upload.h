@@ -0,0 +1,96 @@
+/*
+ * ra_upload.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef INCLUDE_RA_UPLOAD_H_
+#define INCLUDE_RA_UPLOAD_H_
+
+#include <c_port.h>
+#include <stdint.h>
+
+/**
+ * Pixel layouts accepted by RaApplication_SetImage. Channels are listed in
+ * memory order, 8 bit channels are unsigned normalized, 16 bit channels
+ * are native endian unsigned normalized, and 32 bit float channels are
+ * clamped to [0, 1].
+ *
+ * Formats that GL can take directly are uploaded as is, the others are
+ * converted to BGRA8 on the CPU first. YUV formats upload each plane to
+ * its own texture, and are converted to RGB by the shader.
+ */
+enum RaPixelFormat {
+    /**
+     * 32 bit BGRA, same as a little endian cairo ARGB32 surface, default.
+     */
+    RA_PIXEL_BGRA8 = 0,
+    RA_PIXEL_RGBA8,
+    RA_PIXEL_RGB8,
+    RA_PIXEL_BGR8,
+    RA_PIXEL_GRAY8,
+    RA_PIXEL_GRAY16,
+    RA_PIXEL_RGBA16,
+    RA_PIXEL_GRAYF32,
+    RA_PIXEL_RGBAF32,
+
+    /**
+     * 8 bit planar YUV 4:2:0, the full resolution Y plane followed by a
+     * half resolution plane of interleaved U and V.
+     */
+    RA_PIXEL_NV12,
+
+    /**
+     * 8 bit planar YUV 4:2:0, the full resolution Y plane followed by
+     * the half resolution U plane, then the V plane.
+     */
+    RA_PIXEL_I420
+};
+
+/**
+ * How YUV images are converted to RGB. Limited range has Y in [16, 235]
+ * and chroma in [16, 240], as most video, full range uses all 256 values,
+ * as JPEG.
+ */
+enum RaYUVColorSpace {
+    RA_YUV_BT601 = 0,
+    RA_YUV_BT709,
+    RA_YUV_BT601_FULL,
+    RA_YUV_BT709_FULL
+};
+
+/**
+ * Counters for the pixel uploads of a canvas or application image.
+ *
+ * Uploads either go straight from client memory to the texture, or, if
+ * upload buffers are enabled, are copied into a ring of pixel-unpack
+ * buffers and transferred asynchronously.
+ */
+struct RaUploadStats {
+
+    /**
+     * number of texture upload calls issued
+     */
+    uint64_t uploads;
+
+    /**
+     * number of bytes copied to GL
+     */
+    uint64_t bytes;
+
+    /**
+     * number of times the next upload buffer in the ring was still in use
+     * by the GPU. A starved upload falls back to a synchronous upload
+     * from client memory, if this keeps growing, use more buffers.
+     */
+    uint64_t starved;
+
+    /**
+     * number of bytes not uploaded because content hashing found them
+     * unchanged since the last flush, see RaCanvas_SetContentHashing.
+     */
+    uint64_t skipped_bytes;
+};
+
+#endif /* INCLUDE_RA_UPLOAD_H_ */
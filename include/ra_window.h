@@ -9,6 +9,8 @@
 #define INCLUDE_RA_WINDOW_H_
 
 #include <c_port.h>
+#include <ra_fence.h>
+#include <stdint.h>
 
 CAPI_STRUCT(RaWindow);
 
@@ -2814,5 +2816,92 @@ CAPI_FUNC(HRESULT) RaWindow_SwapInterval(int interval);
  */
 CAPI_FUNC(int) RaWindow_ExtensionSupported(const char* extension);
 
+/**
+ * Reads back a rectangle of what was last drawn in the window.
+ *
+ * x and y are the top left corner of the rectangle in framebuffer pixels,
+ * from the top left of the framebuffer. data receives width x height
+ * tightly packed pixels, top row first, in RA_PIXEL_BGRA8 or
+ * RA_PIXEL_RGBA8 format.
+ *
+ * For windows of a headless application this reads the offscreen
+ * framebuffer, call it after RaApplication_DrawFrame. The read waits for
+ * the GPU to finish drawing.
+ *
+ * The back buffer of a GLFW window is undefined once it is swapped, which
+ * is the end of every frame, so GLFW windows can not be read this way,
+ * and E_FAIL is returned. Use RaWindow_ReadPixelsAsync for them.
+ */
+CAPI_FUNC(HRESULT) RaWindow_ReadPixels(RaWindow* window, int x, int y, int width, int height,
+        uint32_t format, void *data);
+
+/**
+ * Counters for the asynchronous reads of a window.
+ */
+struct RaReadStats {
+
+    /**
+     * number of reads queued
+     */
+    uint64_t reads;
+
+    /**
+     * number of bytes delivered
+     */
+    uint64_t bytes;
+
+    /**
+     * number of times every read buffer was still in flight, and a read
+     * had to wait for the oldest one. If this keeps growing, poll more
+     * often or use more buffers.
+     */
+    uint64_t stalls;
+};
+
+/**
+ * Queues a read of a rectangle of what was last drawn in the window,
+ * without waiting for the GPU.
+ *
+ * The arguments are the same as RaWindow_ReadPixels. The pixels are copied
+ * through a ring of pixel-pack buffers, and land in data a frame or two
+ * later, when the read is delivered: data must stay valid until then.
+ * Once data is filled, callback, if not NULL, is called with user_data.
+ *
+ * Reads are delivered in order, at the start of drawing each frame, or by
+ * RaWindow_PollReadPixels. Capturing every frame with a read per frame
+ * does not hold up the frame rate as long as there are enough buffers,
+ * see RaWindow_SetReadBuffers.
+ *
+ * A read of a GLFW window asked for between frames is queued at the end
+ * of drawing the next frame, before its buffers are swapped, so it gets
+ * that frame, not the one on screen when it was asked for. The application
+ * is asked for that frame.
+ */
+CAPI_FUNC(HRESULT) RaWindow_ReadPixelsAsync(RaWindow* window, int x, int y, int width, int height,
+        uint32_t format, void *data, RaFenceCallback callback, void *user_data);
+
+/**
+ * Delivers the asynchronous reads that are done, or, if wait is non-zero,
+ * waits for and delivers all of them. Callbacks may queue new reads.
+ * If wait is non-zero, reads of a GLFW window waiting for the next frame
+ * are issued by drawing the frame right away, unless the window is being
+ * drawn, in which case they are not waited on.
+ *
+ * @returns the number of reads still in flight or waiting for the next
+ * frame, or -1 if window is NULL.
+ */
+CAPI_FUNC(int) RaWindow_PollReadPixels(RaWindow* window, int wait);
+
+/**
+ * Sets the number of pixel-pack buffers for asynchronous reads, default
+ * is 3. Reads in flight are delivered first.
+ */
+CAPI_FUNC(HRESULT) RaWindow_SetReadBuffers(RaWindow* window, int count);
+
+/**
+ * Gets the asynchronous read counters of the window.
+ */
+CAPI_FUNC(HRESULT) RaWindow_GetReadStats(RaWindow* window, struct RaReadStats *stats);
+
 
 #endif /* INCLUDE_RA_WINDOW_H_ */
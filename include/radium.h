@@ -12,7 +12,15 @@
 #include <ra_renderer.h>
 #include <ra_window.h>
 #include <ra_application.h>
+#include <ra_asset.h>
+#include <ra_atlas.h>
 #include <ra_canvas.h>
+#include <ra_canvas_batch.h>
+#include <ra_capture.h>
+#include <ra_fence.h>
+#include <ra_jpeg.h>
+#include <ra_program_cache.h>
+#include <ra_upload.h>
 
 
 
@@ -0,0 +1,47 @@
+/*
+ * CanvasBatchShader.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "CanvasBatchShader.h"
+
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+
+#include "ra_program_cache.hpp"
+
+namespace Magnum { namespace Examples {
+
+CanvasBatchShader::CanvasBatchShader() {
+    MAGNUM_ASSERT_GL_VERSION_SUPPORTED(GL::Version::GL330);
+
+    const Utility::Resource rs{"textured-triangle-data"};
+
+    /* only compiled if there is no binary of the program saved */
+    const bool linked = RaProgramCache::shared().link(id(),
+        {rs.getRaw("CanvasBatchShader.vert"), rs.getRaw("CanvasBatchShader.frag")},
+        [this, &rs] {
+            GL::Shader vert{GL::Version::GL330, GL::Shader::Type::Vertex};
+            GL::Shader frag{GL::Version::GL330, GL::Shader::Type::Fragment};
+
+            vert.addSource(rs.get("CanvasBatchShader.vert"));
+            frag.addSource(rs.get("CanvasBatchShader.frag"));
+
+            CORRADE_INTERNAL_ASSERT_OUTPUT(GL::Shader::compile({vert, frag}));
+
+            attachShaders({vert, frag});
+
+            return link();
+        });
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(linked);
+
+    setUniform(uniformLocation("textureData"), TextureUnit);
+}
+
+}}
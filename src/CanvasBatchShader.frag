@@ -0,0 +1,10 @@
+uniform sampler2DArray textureData;
+
+in vec3 interpolatedTextureCoordinates;
+
+out vec4 fragmentColor;
+
+/* canvases are premultiplied, and blended with (One, OneMinusSourceAlpha) */
+void main() {
+    fragmentColor = texture(textureData, interpolatedTextureCoordinates);
+}
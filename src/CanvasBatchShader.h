@@ -0,0 +1,50 @@
+/*
+ * CanvasBatchShader.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_CANVASBATCHSHADER_H_
+#define SRC_CANVASBATCHSHADER_H_
+
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/TextureArray.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "ra_gl_state.hpp"
+
+namespace Magnum { namespace Examples {
+
+/**
+ * Draws a batch of canvases from the layers of a texture array in one
+ * instanced call, each instance has its own transformation, layer, and
+ * rectangle of the layer, which is the whole layer for canvas batches, or
+ * the item's place in an atlas page.
+ */
+class CanvasBatchShader: public GL::AbstractShaderProgram {
+    public:
+        typedef GL::Attribute<0, Vector2> Position;
+        typedef GL::Attribute<1, Vector2> TextureCoordinates;
+
+        /* per instance, takes locations 2 to 5 */
+        typedef GL::Attribute<2, Matrix4> Transformation;
+        typedef GL::Attribute<6, Float> Layer;
+
+        /* offset and size in texture coordinates */
+        typedef GL::Attribute<7, Vector4> TextureRect;
+
+        explicit CanvasBatchShader();
+
+        CanvasBatchShader& bindTexture(RaGlState& state, GL::Texture2DArray& texture) {
+            state.bindTexture(TextureUnit, texture);
+            return *this;
+        }
+
+    private:
+        enum: Int { TextureUnit = 0 };
+};
+
+}}
+
+#endif /* SRC_CANVASBATCHSHADER_H_ */
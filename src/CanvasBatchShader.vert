@@ -0,0 +1,17 @@
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 textureCoordinates;
+
+/* per instance, the quad to clip space, the canvas layer in the array, and
+   the offset and size of the canvas in the layer */
+layout(location = 2) in mat4 transformation;
+layout(location = 6) in float layer;
+layout(location = 7) in vec4 textureRect;
+
+out vec3 interpolatedTextureCoordinates;
+
+void main() {
+    interpolatedTextureCoordinates = vec3(
+        textureRect.xy + textureCoordinates*textureRect.zw, layer);
+
+    gl_Position = transformation*position;
+}
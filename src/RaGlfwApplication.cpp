@@ -19,6 +19,8 @@
 
 #include "ra_window.hpp"
 #include "ra_canvas.hpp"
+#include "ra_gl_registry.hpp"
+#include <carbon.h>
 
 #include "TexturedTriangleShader.h"
 
@@ -27,87 +29,75 @@ namespace Magnum { namespace Examples {
 
 
 RaGlfwApplication::RaGlfwApplication(const Arguments& arguments):
-    win{NULL}, Platform::GlfwApplication{arguments, Configuration{}
-        .setTitle("Radium Test")}
+    RaGlfwApplication{arguments, Configuration{}.setTitle("Radium Test")}
 {
-    struct TriangleVertex {
-        Vector2 position;
-        Vector2 textureCoordinates;
-    };
-    const TriangleVertex data[]{
-        {{-1.f, -1.f}, {0.0f, 1.0f}}, /* Left position and texture coordinate */
-        {{ 1.f, -1.f}, {1.0f, 1.0f}}, /* Right position and texture coordinate */
-        {{-1.f,  1.f}, {0.0f, 0.0f}},  /* Top position and texture coordinate */
-        {{ 1.f,  1.f}, {1.0f, 0.0f}}  /* Top position and texture coordinate */
-    };
-
-    GL::Buffer buffer;
-    buffer.setData(data);
-    _mesh.setCount(4)
-        .setPrimitive(Magnum::GL::MeshPrimitive::TriangleStrip)
-        .addVertexBuffer(std::move(buffer), 0,
-            TexturedTriangleShader::Position{},
-            TexturedTriangleShader::TextureCoordinates{});
-
-    Magnum::Trade::TgaImporter importer;
-
-    /* Load the texture */
-    const Utility::Resource rs{"textured-triangle-data"};
-    if(!importer.openData(rs.getRaw("cobra.tga")))
-        std::exit(2);
-
-    /* Set texture data and parameters */
-    Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
-    CORRADE_INTERNAL_ASSERT(image);
-
-    uint32_t i = GL_BGRA;
-
+}
 
+RaGlfwApplication::RaGlfwApplication(const Arguments& arguments,
+        const Configuration& configuration):
+    win{NULL}, Platform::GlfwApplication{arguments, configuration}
+{
+}
 
+HRESULT RaGlfwApplication::run()
+{
+    exec();
+    return S_OK;
+}
 
-    GL::TextureFormat tf = (GL::TextureFormat)i;
+HRESULT RaGlfwApplication::drawFrame()
+{
+    redraw();
+    mainLoopIteration();
+    return S_OK;
+}
 
-    _texture.setWrapping(GL::SamplerWrapping::ClampToEdge)
-        .setMagnificationFilter(GL::SamplerFilter::Linear)
-        .setMinificationFilter(GL::SamplerFilter::Linear)
-        .setStorage(1, GL::textureFormat(image->format()), image->size())
-        .setSubImage(0, {}, *image);
+RaWindow *RaGlfwApplication::getWindow()
+{
+    if(!win) {
+        win = RaWindow::New(window());
 
+        // the main loop sleeps until asked for a frame
+        win->redraw = [this] { redraw(); };
+        win->drawNow = [this] { drawEvent(); };
+    }
 
+    return win;
 }
 
 void RaGlfwApplication::drawEvent() {
+    _assets.update();
+
     GL::defaultFramebuffer.clear(GL::FramebufferClear::Color);
 
-    /*
+    RaGlRegistry::current().state().beginFrame();
 
-    using namespace Math::Literals;
+    _image.draw();
 
-    _shader
-        .setColor(0xffb2b2_rgbf)
-        .bindTexture(_texture)
-        .draw(_mesh);
-        */
-    if(win && win->canvas) {
-        win->canvas->draw();
+    if(win) {
+        win->draw();
     }
 
     swapBuffers();
-}
-
-HRESULT RaGlfwApplication::RaGlfwApplication::setImage(uint32_t width,
-        uint32_t height, uint32_t format, const void *data)
-{
 
-    Containers::ArrayView av{data, width * height * 4};
-
-    ImageView2D iv{GL::PixelFormat::BGRA, GL::PixelType::UnsignedByte, {(int)width, (int)height}, av};
-
-    _texture.setSubImage(0, {}, iv);
+    // frames from a producer thread, and assets decoded on the workers,
+    // can not wake up the main loop, so keep drawing, paced by the buffer
+    // swap
+    if((win && win->canvas && win->canvas->threaded) || _assets.pending()) {
+        redraw();
+    }
+}
 
-    //ImageView2D iv = ImageView2D{PixelFormat::RGBA8Unorm, {width, height}, (const unsigned char*)data};
+void RaGlfwApplication::viewportEvent(ViewportEvent& event) {
+    GL::defaultFramebuffer.setViewport({{}, event.framebufferSize()});
 
-    return S_OK;
+    // only canvases that asked for it, the user may be holding on to the
+    // surface and cairo object, and a producer thread may be drawing into
+    // a threaded canvas
+    if(win && win->canvas && (win->canvas->flags & RA_CANVAS_RESIZE_WITH_WINDOW) &&
+       !win->canvas->threaded) {
+        RaCanvas_Resize(win->canvas, event.framebufferSize().x(), event.framebufferSize().y());
+    }
 }
 
 }}
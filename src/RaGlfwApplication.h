@@ -25,7 +25,8 @@
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Platform/GlfwApplication.h>
 
-#include "TexturedTriangleShader.h"
+#include "ra_asset.hpp"
+#include "ra_image.hpp"
 
 namespace Magnum { namespace Examples {
 
@@ -33,7 +34,20 @@ class RaGlfwApplication : public RaApplication, public Platform::GlfwApplication
     public:
         explicit RaGlfwApplication(const Arguments& arguments);
 
-       HRESULT setImage(uint32_t width, uint32_t height, uint32_t format, const void* data);
+        RaGlfwApplication(const Arguments& arguments, const Configuration& configuration);
+
+        HRESULT run() override;
+
+        /**
+         * redraws the window and processes pending events, once.
+         */
+        HRESULT drawFrame() override;
+
+        RaWindow *getWindow() override;
+
+        RaImage &image() override { return _image; }
+
+        RaAssetLoader &assets() override { return _assets; }
 
        /**
         * Pointer to wrapper window.
@@ -43,9 +57,14 @@ class RaGlfwApplication : public RaApplication, public Platform::GlfwApplication
     private:
         void drawEvent() override;
 
-        GL::Mesh _mesh;
-        TexturedTriangleShader _shader;
-        GL::Texture2D _texture;
+        /**
+         * resizes the canvas of the window with the framebuffer, if it was
+         * created with RA_CANVAS_RESIZE_WITH_WINDOW.
+         */
+        void viewportEvent(ViewportEvent& event) override;
+
+        RaAssetLoader _assets;
+        RaImage _image;
 };
 
 }}
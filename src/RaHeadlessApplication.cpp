@@ -0,0 +1,68 @@
+/*
+ * RaHeadlessApplication.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "RaHeadlessApplication.h"
+#include "ra_window.hpp"
+#include "ra_canvas.hpp"
+#include "ra_gl_registry.hpp"
+#include <carbon.h>
+
+#include <Magnum/GL/RenderbufferFormat.h>
+
+namespace Magnum { namespace Examples {
+
+RaHeadlessApplication::RaHeadlessApplication(const Arguments& arguments,
+        int width, int height):
+    RaWindowlessApplication{arguments},
+    _framebuffer{Range2Di{{}, {width, height}}}, _win{NULL}
+{
+    _color.setStorage(GL::RenderbufferFormat::RGBA8, {width, height});
+    _framebuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, _color);
+
+    if(_framebuffer.checkStatus(GL::FramebufferTarget::Draw) !=
+       GL::Framebuffer::Status::Complete) {
+        c_error(E_FAIL, "offscreen framebuffer is not complete");
+    }
+
+    _win = RaWindow::NewHeadless(&_framebuffer, width, height);
+}
+
+RaHeadlessApplication::~RaHeadlessApplication()
+{
+    // reads in flight still go to their callers
+    RaWindow_PollReadPixels(_win, 1);
+    delete _win;
+}
+
+int RaHeadlessApplication::exec()
+{
+    return SUCCEEDED(drawFrame()) ? 0 : 1;
+}
+
+HRESULT RaHeadlessApplication::run()
+{
+    return drawFrame();
+}
+
+HRESULT RaHeadlessApplication::drawFrame()
+{
+    _assets.update();
+
+    _framebuffer
+        .clear(GL::FramebufferClear::Color)
+        .bind();
+
+    RaGlRegistry::current().state().beginFrame();
+
+    _image.draw();
+
+    _win->draw();
+
+    return S_OK;
+}
+
+}}
@@ -0,0 +1,84 @@
+/*
+ * RaHeadlessApplication.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RaHeadlessApplication_H_
+#define SRC_RaHeadlessApplication_H_
+
+#include <ra_application.hpp>
+
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderbuffer.h>
+
+#if defined(CORRADE_TARGET_APPLE)
+#include <Magnum/Platform/WindowlessCglApplication.h>
+#elif defined(CORRADE_TARGET_WINDOWS)
+#include <Magnum/Platform/WindowlessWglApplication.h>
+#else
+#include <Magnum/Platform/WindowlessEglApplication.h>
+#endif
+
+#include "ra_asset.hpp"
+#include "ra_image.hpp"
+
+namespace Magnum { namespace Examples {
+
+#if defined(CORRADE_TARGET_APPLE)
+typedef Platform::WindowlessCglApplication RaWindowlessApplication;
+#elif defined(CORRADE_TARGET_WINDOWS)
+typedef Platform::WindowlessWglApplication RaWindowlessApplication;
+#else
+typedef Platform::WindowlessEglApplication RaWindowlessApplication;
+#endif
+
+/**
+ * Application with no window or display, that draws into an offscreen
+ * framebuffer.
+ *
+ * On Linux the context is a surfaceless EGL one, so it also runs on nodes
+ * with no X server, i.e. with Mesa llvmpipe. The window has the same
+ * canvases, batches and atlases as a GLFW window, drawn the same way, and
+ * each frame is drawn on request with drawFrame, then read back with
+ * RaWindow_ReadPixels.
+ */
+class RaHeadlessApplication : public RaApplication, public RaWindowlessApplication {
+    public:
+        RaHeadlessApplication(const Arguments& arguments, int width, int height);
+
+        /**
+         * frees the window, while the context its read buffers belong to
+         * is still current.
+         */
+        ~RaHeadlessApplication();
+
+        /**
+         * draws a single frame.
+         */
+        int exec() override;
+
+        HRESULT run() override;
+
+        HRESULT drawFrame() override;
+
+        RaWindow *getWindow() override { return _win; }
+
+        RaImage &image() override { return _image; }
+
+        RaAssetLoader &assets() override { return _assets; }
+
+        bool isHeadless() const override { return true; }
+
+    private:
+        GL::Renderbuffer _color;
+        GL::Framebuffer _framebuffer;
+        RaWindow *_win;
+        RaAssetLoader _assets;
+        RaImage _image;
+};
+
+}}
+
+#endif /* SRC_RaHeadlessApplication_H_ */
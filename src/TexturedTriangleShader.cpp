@@ -35,6 +35,8 @@
 #include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Version.h>
 
+#include "ra_program_cache.hpp"
+
 namespace Magnum { namespace Examples {
 
 TexturedTriangleShader::TexturedTriangleShader() {
@@ -42,19 +44,28 @@ TexturedTriangleShader::TexturedTriangleShader() {
 
     const Utility::Resource rs{"textured-triangle-data"};
 
-    GL::Shader vert{GL::Version::GL330, GL::Shader::Type::Vertex};
-    GL::Shader frag{GL::Version::GL330, GL::Shader::Type::Fragment};
+    /* only compiled if there is no binary of the program saved */
+    const bool linked = RaProgramCache::shared().link(id(),
+        {rs.getRaw("TexturedTriangleShader.vert"), rs.getRaw("TexturedTriangleShader.frag")},
+        [this, &rs] {
+            GL::Shader vert{GL::Version::GL330, GL::Shader::Type::Vertex};
+            GL::Shader frag{GL::Version::GL330, GL::Shader::Type::Fragment};
+
+            vert.addSource(rs.get("TexturedTriangleShader.vert"));
+            frag.addSource(rs.get("TexturedTriangleShader.frag"));
 
-    vert.addSource(rs.get("TexturedTriangleShader.vert"));
-    frag.addSource(rs.get("TexturedTriangleShader.frag"));
+            CORRADE_INTERNAL_ASSERT_OUTPUT(GL::Shader::compile({vert, frag}));
 
-    CORRADE_INTERNAL_ASSERT_OUTPUT(GL::Shader::compile({vert, frag}));
+            attachShaders({vert, frag});
 
-    attachShaders({vert, frag});
+            return link();
+        });
 
-    CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+    CORRADE_INTERNAL_ASSERT_OUTPUT(linked);
 
     _colorUniform = uniformLocation("color");
+    _alphaBlendingUniform = uniformLocation("alphaBlending");
+    _textureScaleUniform = uniformLocation("textureScale");
 
     setUniform(uniformLocation("textureData"), TextureUnit);
 }
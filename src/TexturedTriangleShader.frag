@@ -30,11 +30,22 @@
 uniform vec3 color = vec3(1.0, 1.0, 1.0);
 uniform sampler2D textureData;
 
+/* same as in the vertex shader */
+uniform vec2 textureScale = vec2(1.0);
+
+/* keep the texture alpha, for blending premultiplied cairo surfaces */
+uniform bool alphaBlending = false;
+
 in vec2 interpolatedTextureCoordinates;
 
 out vec4 fragmentColor;
 
 void main() {
-    fragmentColor.rgb = color*texture(textureData, interpolatedTextureCoordinates).rgb;
-    fragmentColor.a = 1.0;
+    /* pooled textures are larger than the image in them, and what is
+       past its edge is left from earlier users, so keep linear filtering
+       half a texel inside the image */
+    vec2 limit = textureScale - 0.5/vec2(textureSize(textureData, 0));
+    vec4 texel = texture(textureData, min(interpolatedTextureCoordinates, limit));
+    fragmentColor.rgb = color*texel.rgb;
+    fragmentColor.a = alphaBlending ? texel.a : 1.0;
 }
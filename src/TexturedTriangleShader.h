@@ -33,6 +33,8 @@
 #include <Magnum/GL/Texture.h>
 #include <Magnum/Math/Color.h>
 
+#include "ra_gl_state.hpp"
+
 namespace Magnum { namespace Examples {
 
 class TexturedTriangleShader: public GL::AbstractShaderProgram {
@@ -47,8 +49,27 @@ class TexturedTriangleShader: public GL::AbstractShaderProgram {
             return *this;
         }
 
-        TexturedTriangleShader& bindTexture(GL::Texture2D& texture) {
-            texture.bind(TextureUnit);
+        /**
+         * output the texture alpha instead of 1, the texture must have
+         * premultiplied alpha, as cairo surfaces do.
+         */
+        TexturedTriangleShader& setAlphaBlending(bool enabled) {
+            setUniform(_alphaBlendingUniform, enabled);
+            return *this;
+        }
+
+        /**
+         * fraction of the texture that is drawn, for textures that are
+         * larger than the image in them. Sampling is clamped half a texel
+         * inside it, so what is past the image never filters in.
+         */
+        TexturedTriangleShader& setTextureScale(const Vector2& scale) {
+            setUniform(_textureScaleUniform, scale);
+            return *this;
+        }
+
+        TexturedTriangleShader& bindTexture(RaGlState& state, GL::Texture2D& texture) {
+            state.bindTexture(TextureUnit, texture);
             return *this;
         }
 
@@ -56,6 +77,8 @@ class TexturedTriangleShader: public GL::AbstractShaderProgram {
         enum: Int { TextureUnit = 0 };
 
         Int _colorUniform;
+        Int _alphaBlendingUniform;
+        Int _textureScaleUniform;
 };
 
 }}
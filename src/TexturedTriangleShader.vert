@@ -30,10 +30,12 @@
 layout(location = 0) in vec4 position;
 layout(location = 1) in vec2 textureCoordinates;
 
+uniform vec2 textureScale = vec2(1.0);
+
 out vec2 interpolatedTextureCoordinates;
 
 void main() {
-    interpolatedTextureCoordinates = textureCoordinates;
+    interpolatedTextureCoordinates = textureCoordinates*textureScale;
 
     gl_Position = position;
 }
@@ -0,0 +1,86 @@
+/*
+ * YuvShader.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "YuvShader.h"
+#include <ra_upload.h>
+
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Matrix.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "ra_program_cache.hpp"
+
+namespace Magnum { namespace Examples {
+
+YuvShader::YuvShader() {
+    MAGNUM_ASSERT_GL_VERSION_SUPPORTED(GL::Version::GL330);
+
+    const Utility::Resource rs{"textured-triangle-data"};
+
+    /* only compiled if there is no binary of the program saved */
+    const bool linked = RaProgramCache::shared().link(id(),
+        {rs.getRaw("TexturedTriangleShader.vert"), rs.getRaw("YuvShader.frag")},
+        [this, &rs] {
+            GL::Shader vert{GL::Version::GL330, GL::Shader::Type::Vertex};
+            GL::Shader frag{GL::Version::GL330, GL::Shader::Type::Fragment};
+
+            vert.addSource(rs.get("TexturedTriangleShader.vert"));
+            frag.addSource(rs.get("YuvShader.frag"));
+
+            CORRADE_INTERNAL_ASSERT_OUTPUT(GL::Shader::compile({vert, frag}));
+
+            attachShaders({vert, frag});
+
+            return link();
+        });
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(linked);
+
+    _interleavedChromaUniform = uniformLocation("interleavedChroma");
+    _colorMatrixUniform = uniformLocation("colorMatrix");
+    _colorOffsetUniform = uniformLocation("colorOffset");
+
+    setUniform(uniformLocation("textureY"), TextureUnitY);
+    setUniform(uniformLocation("textureU"), TextureUnitU);
+    setUniform(uniformLocation("textureV"), TextureUnitV);
+
+    setColorSpace(RA_YUV_BT601);
+}
+
+YuvShader& YuvShader::setColorSpace(uint32_t colorSpace) {
+    /* red from V, green from U and V, blue from U, Kr, Kb from the standard */
+    Float rv, gu, gv, bu;
+    if(colorSpace == RA_YUV_BT709 || colorSpace == RA_YUV_BT709_FULL) {
+        rv = 1.5748f; gu = 0.187324f; gv = 0.468124f; bu = 1.8556f;
+    } else {
+        rv = 1.402f; gu = 0.344136f; gv = 0.714136f; bu = 1.772f;
+    }
+
+    /* limited range stretches Y from [16, 235] and chroma from [16, 240] */
+    Float ys = 1.0f, cs = 1.0f, yo = 0.0f;
+    if(colorSpace == RA_YUV_BT601 || colorSpace == RA_YUV_BT709) {
+        ys = 255.0f/219.0f;
+        cs = 255.0f/224.0f;
+        yo = 16.0f/255.0f;
+    }
+
+    /* columns multiply Y, U and V */
+    const Matrix3x3 m{
+        Vector3{ys, ys, ys},
+        Vector3{0.0f, -gu*cs, bu*cs},
+        Vector3{rv*cs, -gv*cs, 0.0f}};
+
+    setUniform(_colorMatrixUniform, m);
+    setUniform(_colorOffsetUniform, Vector3{yo, 128.0f/255.0f, 128.0f/255.0f});
+    return *this;
+}
+
+}}
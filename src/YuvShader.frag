@@ -0,0 +1,29 @@
+uniform sampler2D textureY;
+uniform sampler2D textureU;
+uniform sampler2D textureV;
+
+/* NV12 keeps U and V interleaved in the red and green of textureU */
+uniform bool interleavedChroma = false;
+
+/* YUV to RGB for the color space, range scaling included */
+uniform mat3 colorMatrix;
+uniform vec3 colorOffset;
+
+in vec2 interpolatedTextureCoordinates;
+
+out vec4 fragmentColor;
+
+void main() {
+    vec3 yuv;
+    yuv.x = texture(textureY, interpolatedTextureCoordinates).r;
+
+    if(interleavedChroma) {
+        yuv.yz = texture(textureU, interpolatedTextureCoordinates).rg;
+    } else {
+        yuv.y = texture(textureU, interpolatedTextureCoordinates).r;
+        yuv.z = texture(textureV, interpolatedTextureCoordinates).r;
+    }
+
+    fragmentColor.rgb = clamp(colorMatrix*(yuv - colorOffset), 0.0, 1.0);
+    fragmentColor.a = 1.0;
+}
@@ -0,0 +1,70 @@
+/*
+ * YuvShader.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_YUVSHADER_H_
+#define SRC_YUVSHADER_H_
+
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "ra_gl_state.hpp"
+
+namespace Magnum { namespace Examples {
+
+/**
+ * Variant of TexturedTriangleShader that draws planar YUV images, and does
+ * the YUV to RGB conversion per fragment.
+ *
+ * Takes the same vertex attributes as TexturedTriangleShader, so it draws
+ * the same meshes.
+ */
+class YuvShader: public GL::AbstractShaderProgram {
+    public:
+        typedef GL::Attribute<0, Vector2> Position;
+        typedef GL::Attribute<1, Vector2> TextureCoordinates;
+
+        explicit YuvShader();
+
+        /**
+         * one of RaYUVColorSpace
+         */
+        YuvShader& setColorSpace(uint32_t colorSpace);
+
+        /**
+         * NV12, Y plane in an R8 texture, interleaved UV plane in an RG8 texture.
+         */
+        YuvShader& bindTextures(RaGlState& state, GL::Texture2D& y, GL::Texture2D& uv) {
+            state.bindTexture(TextureUnitY, y);
+            state.bindTexture(TextureUnitU, uv);
+            setUniform(_interleavedChromaUniform, true);
+            return *this;
+        }
+
+        /**
+         * I420, each plane in an R8 texture.
+         */
+        YuvShader& bindTextures(RaGlState& state, GL::Texture2D& y, GL::Texture2D& u,
+                GL::Texture2D& v) {
+            state.bindTexture(TextureUnitY, y);
+            state.bindTexture(TextureUnitU, u);
+            state.bindTexture(TextureUnitV, v);
+            setUniform(_interleavedChromaUniform, false);
+            return *this;
+        }
+
+    private:
+        enum: Int { TextureUnitY = 0, TextureUnitU = 1, TextureUnitV = 2 };
+
+        Int _interleavedChromaUniform;
+        Int _colorMatrixUniform;
+        Int _colorOffsetUniform;
+};
+
+}}
+
+#endif /* SRC_YUVSHADER_H_ */
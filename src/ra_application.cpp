@@ -7,10 +7,13 @@
 
 #include "ra_application.hpp"
 #include "RaGlfwApplication.h"
+#include "RaHeadlessApplication.h"
+#include <ra_asset.h>
 #include <ra_window.hpp>
 #include <carbon.h>
 
 using App = Magnum::Examples::RaGlfwApplication;
+using Headless = Magnum::Examples::RaHeadlessApplication;
 
 #define MXGLFW_ERROR() { \
         const char* glfwErrorDesc = NULL; \
@@ -44,27 +47,112 @@ CAPI_FUNC(RaApplication*) RaApplication_Create(int argc, const char** _argv)
     return app;
 }
 
-CAPI_FUNC(HRESULT) RaApplication_Run(RaApplication* _app)
+CAPI_FUNC(RaApplication*) RaApplication_CreateHeadless(int argc, const char** _argv,
+        int width, int height)
 {
-    App* app = (App*)_app;
-    app->exec();
-    return S_OK;
+    if(width <= 0 || height <= 0) {
+        c_error(E_INVALIDARG, "framebuffer size must be positive");
+        return NULL;
+    }
+
+    char** argv = const_cast<char**>(_argv);
+
+    return new Headless({argc, argv}, width, height);
+}
+
+CAPI_FUNC(RaApplication*) RaApplication_CreateWithConfig(const RaApplicationConfig *conf)
+{
+    if(!conf) {
+        c_error(E_INVALIDARG, "config is NULL");
+        return NULL;
+    }
+
+    // argv is the count, argc the strings
+    int argc = conf->argv;
+    char** argv = const_cast<char**>(conf->argc);
+
+    if(conf->window_flags & Windowless) {
+        return RaApplication_CreateHeadless(argc, conf->argc,
+                conf->window_size[0], conf->window_size[1]);
+    }
+
+    App::Configuration configuration;
+    configuration.setTitle(conf->title ? conf->title : "Radium")
+        .setWindowFlags(App::Configuration::WindowFlag(conf->window_flags & ~Windowless));
+
+    if(conf->window_size[0] > 0 && conf->window_size[1] > 0) {
+        configuration.setSize({conf->window_size[0], conf->window_size[1]});
+    }
+
+    return new App({argc, argv}, configuration);
+}
+
+CAPI_FUNC(HRESULT) RaApplication_Run(RaApplication* app)
+{
+    return app->run();
+}
+
+CAPI_FUNC(HRESULT) RaApplication_DrawFrame(RaApplication* app)
+{
+    if(!app) {
+        return c_error(E_INVALIDARG, "app is NULL");
+    }
+    return app->drawFrame();
 }
 
-CAPI_FUNC(HRESULT) RaApplication_SetImage(RaApplication* _app, uint32_t width, uint32_t height, uint32_t format, const void* data)
+CAPI_FUNC(HRESULT) RaApplication_SetImage(RaApplication* app, uint32_t width, uint32_t height, uint32_t format, const void* data)
 {
-    App* app = (App*)_app;
-    return app->setImage(width, height, format, data);
+    return app->image().setImage(width, height, format, data);
+}
+
+CAPI_FUNC(HRESULT) RaApplication_SetImageRegion(RaApplication* app, uint32_t x, uint32_t y,
+        uint32_t width, uint32_t height, uint32_t stride, uint32_t format, const void* data)
+{
+    return app->image().setImageRegion(x, y, width, height, stride, format, data);
+}
+
+CAPI_FUNC(HRESULT) RaApplication_SetImageAsset(RaApplication* app, RaAsset *asset)
+{
+    if(!app) {
+        return c_error(E_INVALIDARG, "app is NULL");
+    }
+
+    return app->image().setAsset(asset);
+}
+
+CAPI_FUNC(HRESULT) RaApplication_SetYUVColorSpace(RaApplication* app, uint32_t colorSpace)
+{
+    return app->image().setYuvColorSpace(colorSpace);
+}
+
+CAPI_FUNC(HRESULT) RaApplication_SetUploadBuffers(RaApplication* app, int count)
+{
+    return app->image().setUploadBuffers(count);
+}
+
+CAPI_FUNC(HRESULT) RaApplication_GetUploadStats(RaApplication* app, RaUploadStats *stats)
+{
+    if(!stats) {
+        return c_error(E_INVALIDARG, "stats is NULL");
+    }
+    *stats = app->image().uploadStats();
+    return S_OK;
 }
 
 CAPI_FUNC(HRESULT) RaApplication_PollEvents(RaApplication *app)
 {
+    if(app && app->isHeadless()) {
+        return S_OK;
+    }
     glfwPollEvents();
     MXGLFW_CHECK();
 }
 
 CAPI_FUNC(HRESULT) RaApplication_WaitEvents(RaApplication *app)
 {
+    if(app && app->isHeadless()) {
+        return S_OK;
+    }
     glfwWaitEvents();
     MXGLFW_CHECK();
 }
@@ -72,16 +160,14 @@ CAPI_FUNC(HRESULT) RaApplication_WaitEvents(RaApplication *app)
 CAPI_FUNC(HRESULT) RaApplication_WaitEventsTimeout(RaApplication *app,
         double timeout)
 {
+    if(app && app->isHeadless()) {
+        return S_OK;
+    }
     glfwWaitEventsTimeout(timeout);
     MXGLFW_CHECK();
 }
 
-CAPI_FUNC(RaWindow*) RaApplication_GetWindow(RaApplication *_app, int id)
+CAPI_FUNC(RaWindow*) RaApplication_GetWindow(RaApplication *app, int id)
 {
-    App* app = (App*)_app;
-    if(!app->win) {
-        app->win = RaWindow::New(app->window());
-    }
-
-    return app->win;
+    return app->getWindow();
 }
@@ -10,8 +10,44 @@
 
 #include <ra_application.h>
 
+class RaImage;
+class RaAssetLoader;
+
+/**
+ * what the C API needs from the windowed and the headless applications.
+ */
 struct RaApplication {
 
+    virtual ~RaApplication() {}
+
+    /**
+     * runs the main loop until the window is closed, headless applications
+     * draw a single frame.
+     */
+    virtual HRESULT run() = 0;
+
+    /**
+     * draws one frame of the window and returns.
+     */
+    virtual HRESULT drawFrame() = 0;
+
+    /**
+     * the application's window, created on first use for windowed
+     * applications.
+     */
+    virtual RaWindow *getWindow() = 0;
+
+    virtual RaImage &image() = 0;
+
+    /**
+     * loads the assets of RaAsset_Load, uploads run with each frame drawn.
+     */
+    virtual RaAssetLoader &assets() = 0;
+
+    /**
+     * headless applications have no GLFW window, and no events.
+     */
+    virtual bool isHeadless() const { return false; }
 };
 
 
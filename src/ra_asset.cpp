@@ -0,0 +1,391 @@
+/*
+ * ra_asset.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_asset.hpp"
+#include "ra_application.hpp"
+#include "ra_decode.hpp"
+#include "ra_thread_pool.hpp"
+#include <ra_upload.h>
+#include <carbon.h>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/GL/TextureFormat.h>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace Magnum;
+
+typedef std::chrono::steady_clock Clock;
+
+static uint64_t nanoseconds(Clock::duration time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+RaAsset::RaAsset(): loader{NULL}, refs{1}, state{RA_ASSET_LOADING}, resource{NULL},
+    resourceSize{0}, width{0}, height{0}, format{RA_PIXEL_RGBA8}, uploadLevel{0},
+    uploadedRows{0}, texture{NoCreate}, callback{NULL}, userData{NULL}
+{
+}
+
+void RaAsset::release()
+{
+    if(refs.fetch_sub(1) == 1) {
+        delete this;
+    }
+}
+
+RaAssetLoader::RaAssetLoader(): _budget{DefaultBudget}, _pending{0}, _decoding{0}, _stats{}
+{
+}
+
+RaAssetLoader::~RaAssetLoader()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _decoded.wait(lock, [this] { return _decoding == 0; });
+    }
+
+    collect();
+
+    for(RaAsset *asset : _uploads) {
+        asset->release();
+    }
+}
+
+RaAsset *RaAssetLoader::load(const char *name, const char *data, size_t size,
+        RaAssetCallback callback, void *userData)
+{
+    RaAsset *asset = new RaAsset();
+    asset->loader = this;
+    asset->name = name;
+    asset->resource = data;
+    asset->resourceSize = size;
+    asset->callback = callback;
+    asset->userData = userData;
+
+    // the loader's reference, until the asset is finished
+    asset->retain();
+
+    _pending += 1;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _decoding += 1;
+    }
+
+    RaThreadPool::shared().submit([this, asset] { decode(asset); });
+
+    return asset;
+}
+
+RaAsset *RaAssetLoader::load(const char *path, RaAssetCallback callback, void *userData)
+{
+    return load(path, NULL, 0, callback, userData);
+}
+
+RaAsset *RaAssetLoader::loadResource(const char *group, const char *name,
+        RaAssetCallback callback, void *userData)
+{
+    // compiled in data lives for the whole process, the workers read it
+    // in place
+    const Utility::Resource rs{group};
+    Containers::ArrayView<const char> data = rs.getRaw(name);
+    if(data.empty()) {
+        c_error(E_INVALIDARG, "no such resource");
+        return NULL;
+    }
+
+    return load(name, data.data(), data.size(), callback, userData);
+}
+
+void RaAssetLoader::decode(RaAsset *asset)
+{
+    Clock::time_point start = Clock::now();
+
+    const char *data = asset->resource;
+    size_t size = asset->resourceSize;
+
+    bool ok = true;
+    if(!data) {
+        asset->file.reset(new RaMappedFile());
+        ok = SUCCEEDED(asset->file->open(asset->name.c_str()));
+        data = asset->file->data();
+        size = asset->file->size();
+    }
+
+    if(ok && RaTextureFile_Is(data, size)) {
+        // already in the layout GL takes, uploaded from the mapped pages
+        RaTextureFile texture;
+        ok = SUCCEEDED(RaTextureFile_Parse(data, size, texture));
+        if(ok) {
+            asset->width = texture.width;
+            asset->height = texture.height;
+            asset->format = texture.format;
+            asset->levels = texture.levels;
+        }
+    }
+    else if(ok) {
+        ok = RaDecode_Image(data, size, asset->pixels, asset->width, asset->height);
+        if(ok) {
+            asset->levels.push_back({asset->pixels.data(), asset->width, asset->height});
+        }
+        asset->file.reset();
+    }
+
+    if(!ok) {
+        asset->levels.clear();
+        asset->file.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        asset->state = ok ? RA_ASSET_UPLOADING : RA_ASSET_FAILED;
+        _ready.push_back(asset);
+        _decoding -= 1;
+        _stats.decode_ns += nanoseconds(Clock::now() - start);
+
+        // under the lock, once it is released a waiting destructor may
+        // return and take the condition variable with it
+        _decoded.notify_all();
+    }
+}
+
+void RaAssetLoader::collect()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _uploads.insert(_uploads.end(), _ready.begin(), _ready.end());
+    _ready.clear();
+}
+
+bool RaAssetLoader::upload(RaAsset *asset, size_t &budget)
+{
+    const int levels = (int)asset->levels.size();
+
+    if(asset->uploadLevel == 0 && asset->uploadedRows == 0) {
+        asset->texture = GL::Texture2D{};
+        asset->texture.setWrapping(GL::SamplerWrapping::ClampToEdge)
+            .setMagnificationFilter(GL::SamplerFilter::Linear)
+            .setMinificationFilter(GL::SamplerFilter::Linear,
+                levels > 1 ? GL::SamplerMipmap::Linear : GL::SamplerMipmap::Base)
+            .setStorage(levels, GL::TextureFormat::RGBA8, {asset->width, asset->height});
+    }
+
+    const RaTextureLevel &level = asset->levels[asset->uploadLevel];
+
+    const size_t rowSize = (size_t)level.width * 4;
+    const int rows = (int)std::min<size_t>(std::max<size_t>(1, budget / rowSize),
+            level.height - asset->uploadedRows);
+    const size_t bytes = rows * rowSize;
+
+    Containers::ArrayView<const void> av{level.data + asset->uploadedRows * rowSize, bytes};
+    ImageView2D iv{asset->format == RA_PIXEL_BGRA8 ? GL::PixelFormat::BGRA : GL::PixelFormat::RGBA,
+        GL::PixelType::UnsignedByte, {level.width, rows}, av};
+
+    asset->texture.setSubImage(asset->uploadLevel, {0, asset->uploadedRows}, iv);
+
+    asset->uploadedRows += rows;
+    budget -= std::min(budget, bytes);
+    _stats.bytes += bytes;
+
+    if(asset->uploadedRows == level.height) {
+        asset->uploadLevel += 1;
+        asset->uploadedRows = 0;
+    }
+
+    return asset->uploadLevel == levels;
+}
+
+void RaAssetLoader::finish(RaAsset *asset)
+{
+    HRESULT result = S_OK;
+
+    if(asset->state == RA_ASSET_FAILED) {
+        result = c_error(E_FAIL, "could not load asset");
+        _stats.failed += 1;
+    }
+    else {
+        asset->state = RA_ASSET_READY;
+        _stats.loaded += 1;
+    }
+
+    asset->levels.clear();
+    asset->pixels.clear();
+    asset->pixels.shrink_to_fit();
+    asset->file.reset();
+
+    if(asset->callback) {
+        asset->callback(asset->userData, asset, result);
+    }
+
+    _pending -= 1;
+    asset->release();
+}
+
+void RaAssetLoader::update()
+{
+    collect();
+
+    if(_uploads.empty()) {
+        return;
+    }
+
+    Clock::time_point start = Clock::now();
+
+    // at least one row goes up each frame
+    size_t budget = std::max<size_t>(_budget, 1);
+
+    while(!_uploads.empty()) {
+        RaAsset *asset = _uploads.front();
+
+        if(asset->state == RA_ASSET_UPLOADING) {
+            if(!budget || !upload(asset, budget)) {
+                break;
+            }
+        }
+
+        _uploads.pop_front();
+        finish(asset);
+    }
+
+    _stats.upload_ns += nanoseconds(Clock::now() - start);
+}
+
+HRESULT RaAssetLoader::wait(RaAsset *asset)
+{
+    if(asset->state == RA_ASSET_READY) {
+        return S_OK;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _decoded.wait(lock, [asset] { return asset->state != RA_ASSET_LOADING; });
+    }
+
+    collect();
+
+    auto it = std::find(_uploads.begin(), _uploads.end(), asset);
+    if(it == _uploads.end()) {
+        return asset->state == RA_ASSET_READY ? S_OK : E_FAIL;
+    }
+    _uploads.erase(it);
+
+    Clock::time_point start = Clock::now();
+
+    if(asset->state == RA_ASSET_UPLOADING) {
+        size_t budget = SIZE_MAX;
+        while(!upload(asset, budget)) {
+        }
+    }
+
+    _stats.upload_ns += nanoseconds(Clock::now() - start);
+
+    // the loader's reference goes with finish, keep the asset for the result
+    asset->retain();
+    finish(asset);
+    HRESULT result = asset->state == RA_ASSET_READY ? S_OK : E_FAIL;
+    asset->release();
+
+    return result;
+}
+
+RaAssetStats RaAssetLoader::stats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    RaAssetStats result = _stats;
+    result.pending = _pending;
+    return result;
+}
+
+CAPI_FUNC(RaAsset*) RaAsset_Load(RaApplication *app, const char *path,
+        RaAssetCallback callback, void *user_data)
+{
+    if(!app || !path) {
+        c_error(E_INVALIDARG, "app or path is NULL");
+        return NULL;
+    }
+
+    return app->assets().load(path, callback, user_data);
+}
+
+CAPI_FUNC(RaAsset*) RaAsset_LoadResource(RaApplication *app, const char *group,
+        const char *name, RaAssetCallback callback, void *user_data)
+{
+    if(!app || !group || !name) {
+        c_error(E_INVALIDARG, "app, group or name is NULL");
+        return NULL;
+    }
+
+    return app->assets().loadResource(group, name, callback, user_data);
+}
+
+CAPI_FUNC(int) RaAsset_GetState(RaAsset *asset)
+{
+    if(!asset) {
+        return c_error(E_INVALIDARG, "asset is NULL");
+    }
+
+    return asset->state;
+}
+
+CAPI_FUNC(HRESULT) RaAsset_GetSize(RaAsset *asset, int *width, int *height)
+{
+    if(!asset || !width || !height) {
+        return c_error(E_INVALIDARG, "asset, width or height is NULL");
+    }
+
+    int state = asset->state;
+    if(state == RA_ASSET_LOADING || state == RA_ASSET_FAILED) {
+        return c_error(E_FAIL, "asset is not decoded");
+    }
+
+    *width = asset->width;
+    *height = asset->height;
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaAsset_Wait(RaAsset *asset)
+{
+    if(!asset) {
+        return c_error(E_INVALIDARG, "asset is NULL");
+    }
+
+    return asset->loader->wait(asset);
+}
+
+CAPI_FUNC(HRESULT) RaAsset_Release(RaAsset *asset)
+{
+    if(!asset) {
+        return c_error(E_INVALIDARG, "asset is NULL");
+    }
+
+    asset->release();
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaAsset_SetUploadBudget(RaApplication *app, size_t bytes)
+{
+    if(!app) {
+        return c_error(E_INVALIDARG, "app is NULL");
+    }
+
+    app->assets().setBudget(bytes);
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaAsset_GetStats(RaApplication *app, RaAssetStats *stats)
+{
+    if(!app || !stats) {
+        return c_error(E_INVALIDARG, "app or stats is NULL");
+    }
+
+    *stats = app->assets().stats();
+    return S_OK;
+}
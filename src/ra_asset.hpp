@@ -0,0 +1,200 @@
+/*
+ * ra_asset.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_ASSET_HPP_
+#define SRC_RA_ASSET_HPP_
+
+#include <ra_asset.h>
+#include "ra_mapped_file.hpp"
+#include "ra_texture_file.hpp"
+
+#include <Magnum/GL/Texture.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class RaAssetLoader;
+
+/**
+ * An image being loaded into a texture, this is also the RaAsset handle of
+ * the public API.
+ *
+ * Reference counted, the loader holds a reference until the asset is ready
+ * or failed, so callers can release their handle at any time.
+ */
+struct RaAsset {
+    RaAssetLoader *loader;
+    std::atomic<int> refs;
+
+    /**
+     * RaAssetState, LOADING until a worker has decoded the pixels, written
+     * by the worker under the loader's lock, then only on the render thread.
+     */
+    std::atomic<int> state;
+
+    /**
+     * file path, or resource name of an asset compiled in
+     */
+    std::string name;
+
+    /**
+     * data of a resource, NULL for a file
+     */
+    const char *resource;
+    size_t resourceSize;
+
+    /**
+     * the file, mapped while it is decoded, or for texture files, until the
+     * levels are uploaded straight from it
+     */
+    std::unique_ptr<RaMappedFile> file;
+
+    /**
+     * decoded RGBA8 pixels, rows top down, freed once uploaded, empty for
+     * texture files
+     */
+    std::vector<uint8_t> pixels;
+    int width;
+    int height;
+
+    /**
+     * levels to upload, RA_PIXEL_RGBA8 or BGRA8, pointing into pixels, the
+     * file or the resource, and the rows of the current level uploaded
+     */
+    uint32_t format;
+    std::vector<RaTextureLevel> levels;
+    int uploadLevel;
+    int uploadedRows;
+
+    /**
+     * created with immutable storage when the first rows are uploaded
+     */
+    Magnum::GL::Texture2D texture;
+
+    RaAssetCallback callback;
+    void *userData;
+
+    RaAsset();
+
+    void retain() { refs.fetch_add(1); }
+
+    /**
+     * deletes the asset with the last reference, on the render thread.
+     */
+    void release();
+};
+
+/**
+ * Decodes assets on the shared thread pool, and uploads them to their
+ * textures on the render thread, with update called once per frame.
+ *
+ * Each frame uploads rows of the decoded assets, oldest first, until the
+ * byte budget is spent, so a frame takes a bounded hit no matter how many
+ * assets are in flight.
+ */
+class RaAssetLoader {
+public:
+
+    static const size_t DefaultBudget = 4 * 1024 * 1024;
+
+    RaAssetLoader();
+
+    /**
+     * waits for the decodes in flight, and drops the references held on
+     * unfinished assets.
+     */
+    ~RaAssetLoader();
+
+    RaAssetLoader(const RaAssetLoader&) = delete;
+    RaAssetLoader& operator=(const RaAssetLoader&) = delete;
+
+    /**
+     * starts loading a file.
+     *
+     * @returns an asset with a reference for the caller.
+     */
+    RaAsset *load(const char *path, RaAssetCallback callback, void *userData);
+
+    /**
+     * starts loading an image compiled into the resources of group.
+     *
+     * @returns an asset with a reference for the caller, NULL if there is
+     * no such resource.
+     */
+    RaAsset *loadResource(const char *group, const char *name,
+            RaAssetCallback callback, void *userData);
+
+    /**
+     * uploads decoded assets up to the budget, and calls the callbacks of
+     * the ones that are done.
+     */
+    void update();
+
+    /**
+     * waits until the asset is decoded, and uploads the rest of it now.
+     */
+    HRESULT wait(RaAsset *asset);
+
+    void setBudget(size_t bytes) { _budget = bytes; }
+
+    /**
+     * number of assets not yet ready or failed, the application keeps
+     * drawing frames while there are any.
+     */
+    int pending() const { return _pending.load(); }
+
+    RaAssetStats stats();
+
+private:
+    RaAsset *load(const char *name, const char *data, size_t size,
+            RaAssetCallback callback, void *userData);
+
+    void decode(RaAsset *asset);
+
+    /**
+     * moves newly decoded assets to the upload list.
+     */
+    void collect();
+
+    /**
+     * uploads rows of a level of an asset, at least one, and takes them
+     * off budget.
+     *
+     * @returns true once every row is uploaded.
+     */
+    bool upload(RaAsset *asset, size_t &budget);
+
+    void finish(RaAsset *asset);
+
+    size_t _budget;
+    std::atomic<int> _pending;
+
+    std::mutex _mutex;
+    std::condition_variable _decoded;
+
+    /**
+     * assets decoded by the workers, not yet seen by the render thread,
+     * and the number of decodes running.
+     */
+    std::vector<RaAsset*> _ready;
+    int _decoding;
+
+    /**
+     * assets being uploaded, only used on the render thread
+     */
+    std::deque<RaAsset*> _uploads;
+
+    RaAssetStats _stats;
+};
+
+#endif /* SRC_RA_ASSET_HPP_ */
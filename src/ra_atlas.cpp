@@ -0,0 +1,535 @@
+/*
+ * ra_atlas.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_atlas.hpp"
+#include "ra_upload.hpp"
+#include <ra_window.hpp>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/TextureFormat.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Magnum;
+using namespace Magnum::Examples;
+
+namespace {
+
+struct Instance {
+    Matrix4 transformation;
+    Float layer;
+    Vector4 textureRect;
+};
+
+}
+
+RaAtlasPage::RaAtlasPage(int size):
+    allocator{size, size}
+{
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, size);
+    damage.setBounds(size, size);
+}
+
+RaAtlasPage::~RaAtlasPage()
+{
+    cairo_surface_destroy(surface);
+}
+
+static RaAtlasItem *get_item(RaAtlas *atlas, int id)
+{
+    if(!atlas || id < 0 || id >= (int)atlas->items.size() || !atlas->items[id].used) {
+        return NULL;
+    }
+    return &atlas->items[id];
+}
+
+static RaRect padded(const RaRect &rect)
+{
+    return {rect.x - RaAtlas::Padding, rect.y - RaAtlas::Padding,
+        rect.w + 2 * RaAtlas::Padding, rect.h + 2 * RaAtlas::Padding};
+}
+
+/**
+ * makes a texture array with room for capacity pages, all pages are
+ * uploaded again on the next flush.
+ */
+static void create_texture(RaAtlas *atlas, int capacity)
+{
+    atlas->texture = GL::Texture2DArray{};
+    atlas->texture.setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setMagnificationFilter(GL::SamplerFilter::Linear)
+        .setMinificationFilter(GL::SamplerFilter::Linear)
+        .setStorage(1, GL::TextureFormat::RGBA8, {atlas->page_size, atlas->page_size, capacity});
+
+    atlas->capacity = capacity;
+
+    for(auto &page : atlas->pages) {
+        page->damage.addAll();
+    }
+}
+
+/**
+ * adds an empty page, growing the texture array if needed, -1 if at the
+ * maximum number of layers.
+ */
+static int add_page(RaAtlas *atlas)
+{
+    int index = (int)atlas->pages.size();
+
+    if(index >= atlas->capacity) {
+        int max = GL::Texture2DArray::maxSize().z();
+        if(index >= max) {
+            return -1;
+        }
+        create_texture(atlas, std::min(max, atlas->capacity * 2));
+    }
+
+    atlas->pages.emplace_back(new RaAtlasPage(atlas->page_size));
+    atlas->pages.back()->damage.addAll();
+    return index;
+}
+
+/**
+ * finds room for a w x h item in the existing pages, and returns the page,
+ * -1 if it fits nowhere.
+ */
+static int place(RaAtlas *atlas, int w, int h, RaRect &rect)
+{
+    RaRect room;
+    for(int i = 0; i < (int)atlas->pages.size(); ++i) {
+        if(atlas->pages[i]->allocator.allocate(w + 2 * RaAtlas::Padding,
+                h + 2 * RaAtlas::Padding, room)) {
+            rect = {room.x + RaAtlas::Padding, room.y + RaAtlas::Padding, w, h};
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void clear_rect(cairo_surface_t *surface, const RaRect &rect)
+{
+    cairo_t *cr = cairo_create(surface);
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_rectangle(cr, rect.x, rect.y, rect.w, rect.h);
+    cairo_fill(cr);
+    cairo_destroy(cr);
+}
+
+static void create_item_surface(RaAtlas *atlas, RaAtlasItem &item)
+{
+    item.surface = cairo_surface_create_for_rectangle(atlas->pages[item.page]->surface,
+            item.rect.x, item.rect.y, item.rect.w, item.rect.h);
+    item.cr = cairo_create(item.surface);
+}
+
+static void destroy_item_surface(RaAtlasItem &item)
+{
+    cairo_destroy(item.cr);
+    cairo_surface_destroy(item.surface);
+    item.cr = NULL;
+    item.surface = NULL;
+}
+
+/**
+ * repacks every item, tallest first, into new pages, and copies their
+ * pixels over.
+ */
+static HRESULT defragment(RaAtlas *atlas)
+{
+    std::vector<int> ids;
+    for(int i = 0; i < (int)atlas->items.size(); ++i) {
+        if(atlas->items[i].used) {
+            ids.push_back(i);
+        }
+    }
+
+    std::sort(ids.begin(), ids.end(), [atlas](int a, int b) {
+        const RaRect &ra = atlas->items[a].rect;
+        const RaRect &rb = atlas->items[b].rect;
+        return ra.h != rb.h ? ra.h > rb.h : ra.w > rb.w;
+    });
+
+    std::vector<std::unique_ptr<RaAtlasPage>> old;
+    old.swap(atlas->pages);
+
+    std::vector<RaRect> rects(atlas->items.size());
+    std::vector<int> pages(atlas->items.size());
+
+    for(int id : ids) {
+        const RaAtlasItem &item = atlas->items[id];
+        int page = place(atlas, item.rect.w, item.rect.h, rects[id]);
+        if(page < 0) {
+            // items fit in pages one at a time, so this can only fail at
+            // the layer limit, when there is one page more than before
+            page = add_page(atlas);
+            if(page < 0) {
+                atlas->pages.swap(old);
+
+                // growing the texture array on the way lost what was in
+                // it, so the restored pages go up again in full
+                for(auto &restored : atlas->pages) {
+                    restored->damage.addAll();
+                }
+                return c_error(E_FAIL, "atlas is at the maximum number of pages");
+            }
+            page = place(atlas, item.rect.w, item.rect.h, rects[id]);
+        }
+        pages[id] = page;
+    }
+
+    for(int id : ids) {
+        RaAtlasItem &item = atlas->items[id];
+        RaRect from = padded(item.rect);
+        RaRect to = padded(rects[id]);
+
+        cairo_surface_flush(old[item.page]->surface);
+
+        cairo_t *cr = cairo_create(atlas->pages[pages[id]]->surface);
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_surface(cr, old[item.page]->surface, to.x - from.x, to.y - from.y);
+        cairo_rectangle(cr, to.x, to.y, to.w, to.h);
+        cairo_fill(cr);
+        cairo_destroy(cr);
+
+        destroy_item_surface(item);
+        item.page = pages[id];
+        item.rect = rects[id];
+        create_item_surface(atlas, item);
+    }
+
+    for(auto &page : atlas->pages) {
+        page->damage.addAll();
+    }
+
+    atlas->defragments += 1;
+    atlas->instances_dirty = true;
+
+    return S_OK;
+}
+
+CAPI_FUNC(RaAtlas*) RaAtlas_Create(RaWindow *win, int page_size)
+{
+    if(!win) {
+        c_error(E_INVALIDARG, "window is NULL");
+        return NULL;
+    }
+
+    if(page_size <= 2 * RaAtlas::Padding || page_size > GL::Texture2DArray::maxSize().x()) {
+        c_error(E_INVALIDARG, "invalid atlas page size");
+        return NULL;
+    }
+
+    RaAtlas *result = new RaAtlas();
+
+    result->window = win;
+    result->page_size = page_size;
+    result->count = 0;
+    result->instances_dirty = true;
+    result->defragments = 0;
+    result->upload_stats = {};
+
+    create_texture(result, 1);
+
+    RaGlRegistry &registry = RaGlRegistry::current();
+    result->quad = registry.quadBuffer();
+    result->shader = registry.batchShader();
+
+    result->mesh.setCount(4)
+        .setPrimitive(GL::MeshPrimitive::TriangleStrip)
+        .addVertexBuffer(*result->quad, 0,
+            CanvasBatchShader::Position{},
+            CanvasBatchShader::TextureCoordinates{})
+        .addVertexBufferInstanced(result->instances, 1, 0,
+            CanvasBatchShader::Transformation{},
+            CanvasBatchShader::Layer{},
+            CanvasBatchShader::TextureRect{});
+
+    win->atlases.push_back(result);
+
+    return result;
+}
+
+CAPI_FUNC(HRESULT) RaAtlas_Destroy(RaAtlas *atlas)
+{
+    if(!atlas) {
+        return c_error(E_INVALIDARG, "atlas is NULL");
+    }
+
+    for(RaAtlasItem &item : atlas->items) {
+        if(item.used) {
+            destroy_item_surface(item);
+        }
+    }
+
+    std::vector<RaAtlas*> &atlases = atlas->window->atlases;
+    atlases.erase(std::remove(atlases.begin(), atlases.end(), atlas), atlases.end());
+
+    delete atlas;
+    return S_OK;
+}
+
+CAPI_FUNC(int) RaAtlas_Add(RaAtlas *atlas, int width, int height)
+{
+    if(!atlas) {
+        c_error(E_INVALIDARG, "atlas is NULL");
+        return -1;
+    }
+
+    int max = atlas->page_size - 2 * RaAtlas::Padding;
+    if(width <= 0 || height <= 0 || width > max || height > max) {
+        c_error(E_INVALIDARG, "atlas item must be positive and fit in a page");
+        return -1;
+    }
+
+    RaRect rect;
+    int page = place(atlas, width, height, rect);
+
+    // never repacks here, that would move the items the caller holds the
+    // surfaces of, a new page is added instead
+    if(page < 0) {
+        page = add_page(atlas);
+        if(page < 0) {
+            c_error(E_FAIL, "atlas is at the maximum number of pages");
+            return -1;
+        }
+        page = place(atlas, width, height, rect);
+    }
+
+    int id;
+    if(!atlas->free_items.empty()) {
+        id = atlas->free_items.back();
+        atlas->free_items.pop_back();
+    }
+    else {
+        id = (int)atlas->items.size();
+        atlas->items.emplace_back();
+    }
+
+    RaAtlasItem &item = atlas->items[id];
+    item.used = true;
+    item.visible = true;
+    item.page = page;
+    item.rect = rect;
+    item.transformation = Matrix4{Math::IdentityInit};
+
+    // the space may have held a removed item
+    RaAtlasPage &p = *atlas->pages[page];
+    RaRect all = padded(rect);
+    clear_rect(p.surface, all);
+    p.damage.add(all.x, all.y, all.w, all.h);
+
+    create_item_surface(atlas, item);
+
+    atlas->count += 1;
+    atlas->instances_dirty = true;
+
+    return id;
+}
+
+CAPI_FUNC(HRESULT) RaAtlas_Remove(RaAtlas *atlas, int id)
+{
+    RaAtlasItem *item = get_item(atlas, id);
+    if(!item) {
+        return c_error(E_INVALIDARG, "invalid atlas item");
+    }
+
+    destroy_item_surface(*item);
+    atlas->pages[item->page]->allocator.release(padded(item->rect));
+    item->used = false;
+
+    atlas->free_items.push_back(id);
+    atlas->count -= 1;
+    atlas->instances_dirty = true;
+
+    return S_OK;
+}
+
+CAPI_FUNC(cairo_surface_t*) RaAtlas_Surface(RaAtlas *atlas, int id)
+{
+    RaAtlasItem *item = get_item(atlas, id);
+    if(!item) {
+        c_error(E_INVALIDARG, "invalid atlas item");
+        return NULL;
+    }
+    return item->surface;
+}
+
+CAPI_FUNC(cairo_t*) RaAtlas_Cairo(RaAtlas *atlas, int id)
+{
+    RaAtlasItem *item = get_item(atlas, id);
+    if(!item) {
+        c_error(E_INVALIDARG, "invalid atlas item");
+        return NULL;
+    }
+    return item->cr;
+}
+
+CAPI_FUNC(HRESULT) RaAtlas_SetPixels(RaAtlas *atlas, int id, const void *data, int stride)
+{
+    RaAtlasItem *item = get_item(atlas, id);
+    if(!item || !data || stride < item->rect.w * 4) {
+        return c_error(E_INVALIDARG, "invalid atlas item, data or stride");
+    }
+
+    cairo_surface_t *page = atlas->pages[item->page]->surface;
+    cairo_surface_flush(page);
+
+    unsigned char *dst = cairo_image_surface_get_data(page);
+    int pageStride = cairo_image_surface_get_stride(page);
+    const unsigned char *src = (const unsigned char*)data;
+
+    for(int row = 0; row < item->rect.h; ++row) {
+        std::memcpy(dst + (std::size_t)(item->rect.y + row) * pageStride + item->rect.x * 4,
+                src + (std::size_t)row * stride, item->rect.w * 4);
+    }
+
+    cairo_surface_mark_dirty_rectangle(page, item->rect.x, item->rect.y,
+            item->rect.w, item->rect.h);
+
+    return RaAtlas_MarkDirty(atlas, id);
+}
+
+CAPI_FUNC(HRESULT) RaAtlas_MarkDirty(RaAtlas *atlas, int id)
+{
+    RaAtlasItem *item = get_item(atlas, id);
+    if(!item) {
+        return c_error(E_INVALIDARG, "invalid atlas item");
+    }
+
+    atlas->pages[item->page]->damage.add(item->rect.x, item->rect.y,
+            item->rect.w, item->rect.h);
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaAtlas_SetTransform(RaAtlas *atlas, int id, const float *matrix)
+{
+    RaAtlasItem *item = get_item(atlas, id);
+    if(!item || !matrix) {
+        return c_error(E_INVALIDARG, "invalid atlas item or matrix");
+    }
+
+    for(int col = 0; col < 4; ++col) {
+        for(int row = 0; row < 4; ++row) {
+            item->transformation[col][row] = matrix[col * 4 + row];
+        }
+    }
+
+    atlas->instances_dirty = true;
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaAtlas_SetVisible(RaAtlas *atlas, int id, int visible)
+{
+    RaAtlasItem *item = get_item(atlas, id);
+    if(!item) {
+        return c_error(E_INVALIDARG, "invalid atlas item");
+    }
+
+    item->visible = visible != 0;
+    atlas->instances_dirty = true;
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaAtlas_Flush(RaAtlas *atlas)
+{
+    if(!atlas) {
+        return c_error(E_INVALIDARG, "atlas is NULL");
+    }
+
+    for(int i = 0; i < (int)atlas->pages.size(); ++i) {
+        RaAtlasPage &page = *atlas->pages[i];
+        if(page.damage.empty()) {
+            continue;
+        }
+
+        // item surfaces draw straight into the page
+        cairo_surface_flush(page.surface);
+
+        const std::vector<RaRect> &rects = page.damage.rects();
+        RaUpload_DirectLayer(atlas->texture, i, RaUpload_SurfaceSource(page.surface),
+                rects.data(), (int)rects.size(), atlas->upload_stats);
+
+        page.damage.clear();
+    }
+
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaAtlas_Defragment(RaAtlas *atlas)
+{
+    if(!atlas) {
+        return c_error(E_INVALIDARG, "atlas is NULL");
+    }
+    return defragment(atlas);
+}
+
+CAPI_FUNC(HRESULT) RaAtlas_GetStats(RaAtlas *atlas, RaAtlasStats *stats)
+{
+    if(!atlas || !stats) {
+        return c_error(E_INVALIDARG, "atlas or stats is NULL");
+    }
+
+    stats->pages = (uint32_t)atlas->pages.size();
+    stats->items = (uint32_t)atlas->count;
+    stats->used_pixels = 0;
+    for(auto &page : atlas->pages) {
+        stats->used_pixels += page->allocator.usedArea();
+    }
+    stats->page_pixels = (uint64_t)atlas->page_size * atlas->page_size * atlas->pages.size();
+    stats->defragments = atlas->defragments;
+    stats->upload_bytes = atlas->upload_stats.bytes;
+    return S_OK;
+}
+
+HRESULT RaAtlas::draw()
+{
+    if(instances_dirty) {
+        std::vector<int> ids;
+        ids.reserve(count);
+        for(int i = 0; i < (int)items.size(); ++i) {
+            if(items[i].used && items[i].visible) {
+                ids.push_back(i);
+            }
+        }
+
+        // by page, and in id order within a page
+        std::stable_sort(ids.begin(), ids.end(), [this](int a, int b) {
+            return items[a].page < items[b].page;
+        });
+
+        Float scale = 1.0f / page_size;
+        std::vector<Instance> data;
+        data.reserve(ids.size());
+        for(int id : ids) {
+            const RaAtlasItem &item = items[id];
+            data.push_back({item.transformation, Float(item.page),
+                {item.rect.x * scale, item.rect.y * scale,
+                 item.rect.w * scale, item.rect.h * scale}});
+        }
+
+        instances.setData(Containers::arrayView(data), GL::BufferUsage::DynamicDraw);
+        mesh.setInstanceCount((Int)data.size());
+        instances_dirty = false;
+    }
+
+    if(mesh.instanceCount() == 0) {
+        return S_OK;
+    }
+
+    RaGlState &state = RaGlRegistry::current().state();
+
+    state.setBlending(true);
+    state.setBlendFunction(GL::Renderer::BlendFunction::One,
+            GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+
+    shader->bindTexture(state, texture);
+    state.draw(*shader, mesh);
+
+    return S_OK;
+}
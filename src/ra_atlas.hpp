@@ -0,0 +1,110 @@
+/*
+ * ra_atlas.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_ATLAS_HPP_
+#define SRC_RA_ATLAS_HPP_
+
+#include <ra_atlas.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/TextureArray.h>
+#include <Magnum/Math/Matrix4.h>
+#include <CanvasBatchShader.h>
+#include "ra_atlas_allocator.hpp"
+#include "ra_damage.hpp"
+#include "ra_gl_registry.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * a page of the atlas, drawn into on the CPU and uploaded to the layer of
+ * the texture array with the same index.
+ */
+struct RaAtlasPage {
+    cairo_surface_t *surface;
+    RaAtlasAllocator allocator;
+
+    /**
+     * items changed since the last flush
+     */
+    RaDamage damage;
+
+    RaAtlasPage(int size);
+
+    ~RaAtlasPage();
+};
+
+struct RaAtlasItem {
+    bool used;
+    bool visible;
+
+    int page;
+
+    /**
+     * the item in the page, without the transparent border around it that
+     * keeps filtering from picking up the neighbors.
+     */
+    RaRect rect;
+
+    /**
+     * sub-surface of the page for rect
+     */
+    cairo_surface_t *surface;
+    cairo_t *cr;
+
+    Magnum::Matrix4 transformation;
+};
+
+struct RaAtlas {
+    /**
+     * border around each item, in pixels
+     */
+    enum { Padding = 1 };
+
+    RaWindow *window;
+
+    int page_size;
+
+    std::vector<std::unique_ptr<RaAtlasPage>> pages;
+
+    /**
+     * one layer per page, capacity layers.
+     */
+    Magnum::GL::Texture2DArray texture{Magnum::NoCreate};
+    int capacity;
+
+    std::vector<RaAtlasItem> items;
+
+    /**
+     * ids of removed items, reused before adding new ones.
+     */
+    std::vector<int> free_items;
+
+    int count;
+
+    /**
+     * the quad of the context, referenced by the mesh, and the program,
+     * shared with the other batches and atlases.
+     */
+    std::shared_ptr<Magnum::GL::Buffer> quad;
+    Magnum::GL::Mesh mesh;
+    std::shared_ptr<Magnum::Examples::CanvasBatchShader> shader;
+
+    /**
+     * per instance data of the visible items, sorted by page, rebuilt
+     * before drawing when items are added, moved or hidden.
+     */
+    Magnum::GL::Buffer instances;
+    bool instances_dirty;
+
+    uint64_t defragments;
+    RaUploadStats upload_stats;
+
+    HRESULT draw();
+};
+
+#endif /* SRC_RA_ATLAS_HPP_ */
@@ -0,0 +1,106 @@
+/*
+ * ra_atlas_allocator.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_atlas_allocator.hpp"
+
+#include <algorithm>
+
+RaAtlasAllocator::RaAtlasAllocator(int width, int height):
+    _width{width}, _height{height}, _top{0}, _used{0}
+{
+}
+
+void RaAtlasAllocator::clear()
+{
+    _shelves.clear();
+    _top = 0;
+    _used = 0;
+}
+
+bool RaAtlasAllocator::allocate(int w, int h, RaRect &rect)
+{
+    if(w <= 0 || h <= 0 || w > _width || h > _height) {
+        return false;
+    }
+
+    // best fit, the shelf that wastes the least height and still has a
+    // long enough free span.
+    Shelf *best = nullptr;
+    std::vector<Span>::iterator bestSpan;
+    for(Shelf &shelf : _shelves) {
+        if(shelf.h < h || (best && shelf.h >= best->h)) {
+            continue;
+        }
+        auto span = std::find_if(shelf.free.begin(), shelf.free.end(),
+                [w](const Span &s) { return s.w >= w; });
+        if(span != shelf.free.end()) {
+            best = &shelf;
+            bestSpan = span;
+        }
+    }
+
+    // a much taller shelf would waste most of its height, open a new one
+    // if there is still room at the bottom.
+    if((!best || best->h > h + h / 2) && _top + h <= _height) {
+        _shelves.push_back({_top, h, {{0, _width}}});
+        _top += h;
+        best = &_shelves.back();
+        bestSpan = best->free.begin();
+    }
+
+    if(!best) {
+        return false;
+    }
+
+    rect = {bestSpan->x, best->y, w, h};
+
+    bestSpan->x += w;
+    bestSpan->w -= w;
+    if(bestSpan->w == 0) {
+        best->free.erase(bestSpan);
+    }
+
+    _used += (int64_t)w * h;
+    return true;
+}
+
+void RaAtlasAllocator::release(const RaRect &rect)
+{
+    auto shelf = std::find_if(_shelves.begin(), _shelves.end(),
+            [&rect](const Shelf &s) { return s.y == rect.y; });
+    if(shelf == _shelves.end()) {
+        return;
+    }
+
+    std::vector<Span> &free = shelf->free;
+
+    auto next = std::lower_bound(free.begin(), free.end(), rect.x,
+            [](const Span &s, int x) { return s.x < x; });
+    next = free.insert(next, {rect.x, rect.w});
+
+    // merge with the following, then the preceding span
+    if(next + 1 != free.end() && next->x + next->w == (next + 1)->x) {
+        next->w += (next + 1)->w;
+        free.erase(next + 1);
+    }
+    if(next != free.begin() && (next - 1)->x + (next - 1)->w == next->x) {
+        (next - 1)->w += next->w;
+        free.erase(next);
+    }
+
+    _used -= (int64_t)rect.w * rect.h;
+
+    // empty shelves at the bottom of the stack give their height back
+    while(!_shelves.empty()) {
+        const Shelf &last = _shelves.back();
+        if(last.free.size() != 1 || last.free[0].w != _width) {
+            break;
+        }
+        _top = last.y;
+        _shelves.pop_back();
+    }
+}
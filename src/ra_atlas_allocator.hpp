@@ -0,0 +1,84 @@
+/*
+ * ra_atlas_allocator.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_ATLAS_ALLOCATOR_HPP_
+#define SRC_RA_ATLAS_ALLOCATOR_HPP_
+
+#include "ra_damage.hpp"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Shelf packing of rectangles into a page.
+ *
+ * The page is split into horizontal shelves stacked from the top, each as
+ * tall as the first rect placed in it. A rect goes into the shelf that
+ * wastes the least height, or opens a new shelf if every existing one is
+ * much taller than it. Each shelf keeps a sorted list of free spans, so
+ * released rects are reused by later ones, and empty shelves at the top
+ * of the stack give their height back to the page.
+ */
+class RaAtlasAllocator {
+public:
+
+    RaAtlasAllocator(int width, int height);
+
+    /**
+     * finds room for a w x h rect.
+     *
+     * @returns false if the page is full.
+     */
+    bool allocate(int w, int h, RaRect &rect);
+
+    /**
+     * gives a rect returned by allocate back to the page.
+     */
+    void release(const RaRect &rect);
+
+    /**
+     * releases everything.
+     */
+    void clear();
+
+    /**
+     * pixels in allocated rects.
+     */
+    int64_t usedArea() const { return _used; }
+
+    int width() const { return _width; }
+
+    int height() const { return _height; }
+
+private:
+    struct Span {
+        int x;
+        int w;
+    };
+
+    struct Shelf {
+        int y;
+        int h;
+
+        /**
+         * free runs of the shelf, sorted by x, never adjacent.
+         */
+        std::vector<Span> free;
+    };
+
+    std::vector<Shelf> _shelves;
+    int _width;
+    int _height;
+
+    /**
+     * bottom of the last shelf
+     */
+    int _top;
+
+    int64_t _used;
+};
+
+#endif /* SRC_RA_ATLAS_ALLOCATOR_HPP_ */
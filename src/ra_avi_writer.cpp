@@ -0,0 +1,217 @@
+/*
+ * ra_avi_writer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_avi_writer.hpp"
+#include <carbon.h>
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * layout of the headers written by open, RIFF and hdrl lists, then the
+ * header of the movi list, the offsets are of the fields patched on close.
+ */
+static const long HeaderSize = 224;
+static const long RiffSizeOffset = 4;
+static const long TotalFramesOffset = 48;
+static const long MainBufferSizeOffset = 60;
+static const long StreamLengthOffset = 140;
+static const long StreamBufferSizeOffset = 144;
+static const long MoviSizeOffset = 216;
+static const long MoviOffset = 220;
+
+static const uint32_t AVIF_HASINDEX = 0x10;
+static const uint32_t AVIIF_KEYFRAME = 0x10;
+
+static void put32(std::vector<uint8_t> &buf, uint32_t value)
+{
+    for(int i = 0; i < 4; ++i) {
+        buf.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void put16(std::vector<uint8_t> &buf, uint16_t value)
+{
+    buf.push_back((uint8_t)value);
+    buf.push_back((uint8_t)(value >> 8));
+}
+
+static void fourcc(std::vector<uint8_t> &buf, const char *code)
+{
+    buf.insert(buf.end(), code, code + 4);
+}
+
+static bool patch32(std::FILE *file, long offset, uint32_t value)
+{
+    std::vector<uint8_t> buf;
+    put32(buf, value);
+    return std::fseek(file, offset, SEEK_SET) == 0 &&
+           std::fwrite(buf.data(), 1, buf.size(), file) == buf.size();
+}
+
+RaAviWriter::RaAviWriter() : _file(NULL), _moviSize(0), _maxChunk(0)
+{
+}
+
+RaAviWriter::~RaAviWriter()
+{
+    if(_file) {
+        close();
+    }
+}
+
+HRESULT RaAviWriter::open(const char *path, int width, int height, double fps)
+{
+    if(_file) {
+        return c_error(E_FAIL, "AVI file is already open");
+    }
+
+    if(!path || width <= 0 || height <= 0 || width > 0xffff || height > 0xffff || fps <= 0) {
+        return c_error(E_INVALIDARG, "invalid AVI path, size or frame rate");
+    }
+
+    _file = std::fopen(path, "wb");
+    if(!_file) {
+        return c_error(E_FAIL, "could not create AVI file");
+    }
+
+    _index.clear();
+    _moviSize = 0;
+    _maxChunk = 0;
+
+    const uint32_t scale = 1000;
+    const uint32_t rate = (uint32_t)std::lround(fps * scale);
+
+    std::vector<uint8_t> h;
+    h.reserve(HeaderSize);
+
+    fourcc(h, "RIFF"); put32(h, 0); fourcc(h, "AVI ");
+
+    fourcc(h, "LIST"); put32(h, 192); fourcc(h, "hdrl");
+
+    // MainAVIHeader
+    fourcc(h, "avih"); put32(h, 56);
+    put32(h, (uint32_t)std::lround(1000000.0 / fps));
+    put32(h, 0);                        // max bytes per sec
+    put32(h, 0);                        // padding granularity
+    put32(h, AVIF_HASINDEX);
+    put32(h, 0);                        // total frames
+    put32(h, 0);                        // initial frames
+    put32(h, 1);                        // streams
+    put32(h, 0);                        // suggested buffer size
+    put32(h, width);
+    put32(h, height);
+    put32(h, 0); put32(h, 0); put32(h, 0); put32(h, 0);
+
+    fourcc(h, "LIST"); put32(h, 116); fourcc(h, "strl");
+
+    // AVIStreamHeader
+    fourcc(h, "strh"); put32(h, 56);
+    fourcc(h, "vids"); fourcc(h, "MJPG");
+    put32(h, 0);                        // flags
+    put16(h, 0);                        // priority
+    put16(h, 0);                        // language
+    put32(h, 0);                        // initial frames
+    put32(h, scale);
+    put32(h, rate);
+    put32(h, 0);                        // start
+    put32(h, 0);                        // length
+    put32(h, 0);                        // suggested buffer size
+    put32(h, 0xffffffff);               // quality, default
+    put32(h, 0);                        // sample size, varies
+    put16(h, 0); put16(h, 0); put16(h, (uint16_t)width); put16(h, (uint16_t)height);
+
+    // BITMAPINFOHEADER
+    fourcc(h, "strf"); put32(h, 40);
+    put32(h, 40);
+    put32(h, width);
+    put32(h, height);
+    put16(h, 1);                        // planes
+    put16(h, 24);                       // bit count
+    fourcc(h, "MJPG");
+    put32(h, (uint32_t)width * height * 3);
+    put32(h, 0); put32(h, 0); put32(h, 0); put32(h, 0);
+
+    fourcc(h, "LIST"); put32(h, 4); fourcc(h, "movi");
+
+    if(std::fwrite(h.data(), 1, h.size(), _file) != h.size()) {
+        std::fclose(_file);
+        _file = NULL;
+        return c_error(E_FAIL, "could not write AVI header");
+    }
+
+    return S_OK;
+}
+
+bool RaAviWriter::write(const void *data, size_t size)
+{
+    if(!_file) {
+        return false;
+    }
+
+    const uint64_t chunk = 8 + size + (size & 1);
+
+    // the RIFF size is 32 bits, and must still fit the index
+    const uint64_t total = HeaderSize + _moviSize + chunk + 8 + (_index.size() + 2) * 8;
+    if(total > 0xffffffffull) {
+        return false;
+    }
+
+    std::vector<uint8_t> header;
+    fourcc(header, "00dc");
+    put32(header, (uint32_t)size);
+
+    static const uint8_t pad = 0;
+
+    if(std::fwrite(header.data(), 1, header.size(), _file) != header.size() ||
+       std::fwrite(data, 1, size, _file) != size ||
+       ((size & 1) && std::fwrite(&pad, 1, 1, _file) != 1)) {
+        return false;
+    }
+
+    _index.push_back((uint32_t)(HeaderSize - MoviOffset + _moviSize));
+    _index.push_back((uint32_t)size);
+    _moviSize += chunk;
+    _maxChunk = std::max(_maxChunk, (uint32_t)size);
+    return true;
+}
+
+HRESULT RaAviWriter::close()
+{
+    if(!_file) {
+        return c_error(E_FAIL, "AVI file is not open");
+    }
+
+    std::vector<uint8_t> idx;
+    idx.reserve(8 + _index.size() * 8);
+    fourcc(idx, "idx1");
+    put32(idx, (uint32_t)(_index.size() * 8));
+    for(size_t i = 0; i < _index.size(); i += 2) {
+        fourcc(idx, "00dc");
+        put32(idx, AVIIF_KEYFRAME);
+        put32(idx, _index[i]);
+        put32(idx, _index[i + 1]);
+    }
+
+    const uint64_t fileSize = HeaderSize + _moviSize + idx.size();
+
+    bool ok = std::fwrite(idx.data(), 1, idx.size(), _file) == idx.size() &&
+              patch32(_file, RiffSizeOffset, (uint32_t)(fileSize - 8)) &&
+              patch32(_file, TotalFramesOffset, frames()) &&
+              patch32(_file, MainBufferSizeOffset, _maxChunk + 8) &&
+              patch32(_file, StreamLengthOffset, frames()) &&
+              patch32(_file, StreamBufferSizeOffset, _maxChunk + 8) &&
+              patch32(_file, MoviSizeOffset, (uint32_t)(4 + _moviSize));
+
+    ok = std::fclose(_file) == 0 && ok;
+    _file = NULL;
+
+    if(!ok) {
+        return c_error(E_FAIL, "could not finish AVI file");
+    }
+    return S_OK;
+}
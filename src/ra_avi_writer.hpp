@@ -0,0 +1,72 @@
+/*
+ * ra_avi_writer.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_AVI_WRITER_HPP_
+#define SRC_RA_AVI_WRITER_HPP_
+
+#include <c_port.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Writes a motion-JPEG AVI, a single video stream where each frame is a
+ * complete JPEG.
+ *
+ * The headers are written with a frame count of zero when the file is
+ * opened, and patched, along with the idx1 index, when it is closed. Files
+ * are plain AVI 1.0, with no OpenDML extensions, so are limited to 4 GB.
+ */
+class RaAviWriter {
+public:
+
+    RaAviWriter();
+
+    /**
+     * closes the file if still open.
+     */
+    ~RaAviWriter();
+
+    RaAviWriter(const RaAviWriter&) = delete;
+    RaAviWriter& operator=(const RaAviWriter&) = delete;
+
+    HRESULT open(const char *path, int width, int height, double fps);
+
+    /**
+     * appends a JPEG as the next frame.
+     *
+     * @returns false if the file is not open, could not be written, or
+     * would grow past the AVI size limit.
+     */
+    bool write(const void *data, size_t size);
+
+    /**
+     * writes the index, patches the headers and closes the file.
+     */
+    HRESULT close();
+
+    uint32_t frames() const { return (uint32_t)(_index.size() / 2); }
+
+private:
+    std::FILE *_file;
+
+    /**
+     * offset and size of each frame chunk, the offsets relative to the
+     * 'movi' list
+     */
+    std::vector<uint32_t> _index;
+
+    /**
+     * bytes in the 'movi' list after its type, and largest chunk
+     */
+    uint64_t _moviSize;
+    uint32_t _maxChunk;
+};
+
+#endif /* SRC_RA_AVI_WRITER_HPP_ */
@@ -20,6 +20,7 @@
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Renderer.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Trade/AbstractImporter.h>
@@ -34,89 +35,709 @@
 using namespace Magnum;
 using namespace Magnum::Examples;
 
+/**
+ * image surface over pooled pixels, the rows are the width of the
+ * storage bucket.
+ */
+static cairo_surface_t *create_surface(unsigned char *pixels, int width, int height,
+        int storageWidth)
+{
+    return cairo_image_surface_create_for_data(pixels, CAIRO_FORMAT_ARGB32,
+            width, height, storageWidth * 4);
+}
+
+RaCanvasLayer::RaCanvasLayer(int width, int height, bool mipmapped):
+    track_damage{false}, dirty{true}, visible{true}
+{
+    RaSurfacePool &pool = RaSurfacePool::shared();
+    RaSurfacePool::storageSize(width, height, storage_width, storage_height);
+
+    // pooled pixels come cleared, so the layer starts transparent
+    pixels = pool.acquirePixels(storage_width, storage_height);
+    surface = create_surface(pixels, width, height, storage_width);
+    cr = cairo_create(surface);
+    damage.setBounds(width, height);
+
+    if(mipmapped) {
+        mips.reset(new RaMipChain(storage_width, storage_height));
+    }
+    texture = pool.acquireTexture(storage_width, storage_height, mips ? mips->levels() : 1);
+}
+
+RaCanvasLayer::~RaCanvasLayer()
+{
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    RaSurfacePool &pool = RaSurfacePool::shared();
+    pool.releasePixels(pixels, storage_width, storage_height);
+    pool.releaseTexture(std::move(texture), storage_width, storage_height,
+            mips ? mips->levels() : 1);
+}
+
+/**
+ * creates the surfaces and texture of the canvas for its size and flags
+ */
+static void create_storage(RaCanvas *canvas)
+{
+    RaSurfacePool &pool = RaSurfacePool::shared();
+    int width = canvas->width;
+    int height = canvas->height;
+
+    RaSurfacePool::storageSize(width, height, canvas->storage_width, canvas->storage_height);
+
+    canvas->pixels = NULL;
+    canvas->surface = NULL;
+    canvas->cr = NULL;
+
+    if(canvas->flags & RA_CANVAS_THREADED) {
+        // the producer thread draws into its own surfaces, which replace
+        // the persistent and tiled modes
+        canvas->threaded.reset(new RaThreadedSurface(width, height,
+                canvas->storage_width, canvas->storage_height));
+    }
+    else if((canvas->flags & RA_CANVAS_PERSISTENT) && RaPersistentSurface::isSupported()) {
+        canvas->persistent.reset(new RaPersistentSurface(width, height, 3));
+        canvas->surface = canvas->persistent->surface();
+        canvas->cr = canvas->persistent->cr();
+    }
+    else {
+        canvas->pixels = pool.acquirePixels(canvas->storage_width, canvas->storage_height);
+        canvas->surface = create_surface(canvas->pixels, width, height, canvas->storage_width);
+
+        // a tiled canvas only ever draws into its recording
+        if(!(canvas->flags & RA_CANVAS_TILED)) {
+            canvas->cr = cairo_create(canvas->surface);
+        }
+    }
+
+    if((canvas->flags & RA_CANVAS_TILED) && !canvas->threaded) {
+        canvas->tiled.reset(new RaTiledSurface(width, height));
+        canvas->cr = canvas->tiled->cr();
+    }
+
+    // mip levels are filtered from the surface memory on the CPU, which
+    // persistent canvases do not read back from
+    if((canvas->flags & RA_CANVAS_MIPMAPPED) && !canvas->persistent) {
+        canvas->mips.reset(new RaMipChain(canvas->storage_width, canvas->storage_height));
+    }
+
+    if(canvas->hash_tile_size > 0 && canvas->pixels) {
+        canvas->hashes.reset(new RaTileHashes(width, height, canvas->hash_tile_size));
+    }
+
+    canvas->texture = pool.acquireTexture(canvas->storage_width, canvas->storage_height,
+            canvas->mips ? canvas->mips->levels() : 1);
+
+    canvas->damage.setBounds(width, height);
+}
+
+/**
+ * gives the surfaces and texture of the canvas back to the pool
+ */
+static void release_storage(RaCanvas *canvas)
+{
+    RaSurfacePool &pool = RaSurfacePool::shared();
+
+    if(canvas->persistent) {
+        // owns the surface and cairo object
+        canvas->persistent.reset();
+    }
+    else if(canvas->threaded) {
+        canvas->threaded.reset();
+    }
+    else {
+        if(!canvas->tiled) {
+            cairo_destroy(canvas->cr);
+        }
+        cairo_surface_destroy(canvas->surface);
+        pool.releasePixels(canvas->pixels, canvas->storage_width, canvas->storage_height);
+    }
+
+    canvas->tiled.reset();
+
+    pool.releaseTexture(std::move(canvas->texture), canvas->storage_width,
+            canvas->storage_height, canvas->mips ? canvas->mips->levels() : 1);
+
+    canvas->mips.reset();
+    canvas->hashes.reset();
+
+    canvas->surface = NULL;
+    canvas->cr = NULL;
+    canvas->pixels = NULL;
+}
+
 CAPI_FUNC(RaCanvas*) RaCanvas_CreateForWindow(RaWindow *win)
+{
+    return RaCanvas_CreateForWindowWithFlags(win, 0);
+}
+
+CAPI_FUNC(RaCanvas*) RaCanvas_CreateForWindowWithFlags(RaWindow *win, uint32_t flags)
 {
     int width, height;
-    glfwGetFramebufferSize(win->window, &width, &height);
+    win->framebufferSize(width, height);
 
-    cairo_surface_t *surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+    RaCanvas *result = new RaCanvas();
 
-    cairo_t *cr = cairo_create(surface);
+    result->window = win;
+    result->flags = flags;
+    result->width = width;
+    result->height = height;
+    result->hash_tile_size = 0;
 
-    RaCanvas *result = new RaCanvas();
+    create_storage(result);
 
-    result->surface = surface;
-    result->cr = cr;
-
-    struct TriangleVertex {
-        Vector2 position;
-        Vector2 textureCoordinates;
-    };
-    const TriangleVertex data[]{
-        {{-1.f, -1.f}, {0.0f, 1.0f}}, /* Left position and texture coordinate */
-        {{ 1.f, -1.f}, {1.0f, 1.0f}}, /* Right position and texture coordinate */
-        {{-1.f,  1.f}, {0.0f, 0.0f}},  /* Top position and texture coordinate */
-        {{ 1.f,  1.f}, {1.0f, 0.0f}}  /* Top position and texture coordinate */
-    };
-
-    GL::Buffer buffer;
-    buffer.setData(data);
-    result->mesh.setCount(4)
-        .setPrimitive(Magnum::GL::MeshPrimitive::TriangleStrip)
-        .addVertexBuffer(std::move(buffer), 0,
-            TexturedTriangleShader::Position{},
-            TexturedTriangleShader::TextureCoordinates{});
-
-    result->texture.setWrapping(GL::SamplerWrapping::ClampToEdge)
-        .setMagnificationFilter(GL::SamplerFilter::Linear)
-        .setMinificationFilter(GL::SamplerFilter::Linear)
-        .setStorage(1, GL::TextureFormat::RGBA8, {width, height});
+    result->track_damage = false;
+    result->upload_stats = {};
 
+    RaGlRegistry &registry = RaGlRegistry::current();
+    result->mesh = registry.quadMesh();
+    result->shader = registry.texturedShader();
 
     win->canvas = result;
 
     return result;
 }
 
+static void run_callbacks(RaCanvas *canvas, bool wait);
+
+CAPI_FUNC(HRESULT) RaCanvas_Destroy(RaCanvas *canvas)
+{
+    if(!canvas) {
+        return c_error(E_INVALIDARG, "canvas is NULL");
+    }
+
+    if(canvas->cache.active()) {
+        return c_error(E_FAIL, "can not destroy a canvas while a cached block is being drawn");
+    }
+
+    if(canvas->window && canvas->window->canvas == canvas) {
+        canvas->window->canvas = NULL;
+    }
+
+    // callbacks usually release what the upload was reading
+    run_callbacks(canvas, true);
+
+    canvas->layers.clear();
+    release_storage(canvas);
+
+    delete canvas;
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_Resize(RaCanvas *canvas, int width, int height)
+{
+    if(!canvas) {
+        return c_error(E_INVALIDARG, "canvas is NULL");
+    }
+
+    if(width <= 0 || height <= 0) {
+        return c_error(E_INVALIDARG, "canvas size must be positive");
+    }
+
+    if(canvas->cache.active()) {
+        return c_error(E_FAIL, "can not resize a canvas while a cached block is being drawn");
+    }
+
+    if(width == canvas->width && height == canvas->height) {
+        return S_OK;
+    }
+
+    // release before acquiring, so a resize within the same bucket gets
+    // the same storage right back.
+    release_storage(canvas);
+
+    canvas->width = width;
+    canvas->height = height;
+
+    create_storage(canvas);
+
+    canvas->damage.clear();
+    canvas->damage.addAll();
+
+    for(auto &layer : canvas->layers) {
+        bool visible = layer->visible;
+        layer.reset();
+        layer.reset(new RaCanvasLayer(width, height,
+                (canvas->flags & RA_CANVAS_MIPMAPPED) != 0));
+        layer->visible = visible;
+    }
+
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_TrimPool()
+{
+    RaSurfacePool::shared().trim();
+    return S_OK;
+}
+
 CAPI_FUNC(cairo_surface_t*) RaCanvas_Surface(RaCanvas *canvas)
 {
-    return canvas->surface;
+    return canvas->threaded ? canvas->threaded->surface() : canvas->surface;
 }
 
 CAPI_FUNC(cairo_t*) RaCanvas_Cairo(RaCanvas *canvas)
 {
-    return canvas->cr;
+    return canvas->threaded ? canvas->threaded->cr() : canvas->cr;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_Publish(RaCanvas *canvas)
+{
+    if(!canvas || !canvas->threaded) {
+        return c_error(E_INVALIDARG, "canvas was not created with RA_CANVAS_THREADED");
+    }
+
+    canvas->threaded->publish();
+    return S_OK;
+}
+
+/**
+ * copies rects of a surface of the canvas to the same location in its
+ * texture, through the upload ring if the canvas has one, and updates the
+ * mip levels under them.
+ */
+static void upload_rects(RaCanvas *canvas, GL::Texture2D &texture,
+        cairo_surface_t *surface, RaMipChain *mips, const RaRect *rects, int count)
+{
+    RaPixelSource src = RaUpload_SurfaceSource(surface);
+
+    if(canvas->upload) {
+        canvas->upload->upload(texture, src, rects, count, canvas->upload_stats);
+    }
+    else {
+        RaUpload_Direct(texture, src, rects, count, canvas->upload_stats);
+    }
+
+    if(mips) {
+        mips->update(texture, src, rects, count, canvas->upload_stats);
+    }
+}
+
+static void flush_layer(RaCanvas *canvas, RaCanvasLayer &layer)
+{
+    if(!layer.dirty) {
+        return;
+    }
+
+    cairo_surface_flush(layer.surface);
+
+    if(layer.track_damage) {
+        const std::vector<RaRect> &rects = layer.damage.rects();
+        upload_rects(canvas, layer.texture, layer.surface, layer.mips.get(),
+                rects.data(), (int)rects.size());
+    }
+    else {
+        RaRect all = {0, 0, cairo_image_surface_get_width(layer.surface),
+            cairo_image_surface_get_height(layer.surface)};
+        upload_rects(canvas, layer.texture, layer.surface, layer.mips.get(), &all, 1);
+    }
+
+    layer.damage.clear();
+    layer.dirty = false;
+}
+
+/**
+ * layer n of the API, n > 0, NULL if out of range
+ */
+static RaCanvasLayer *get_layer(RaCanvas *canvas, int layer)
+{
+    if(!canvas || layer < 1 || layer > (int)canvas->layers.size()) {
+        return NULL;
+    }
+    return canvas->layers[layer - 1].get();
+}
+
+/**
+ * calls the callbacks whose fences are signaled, or waits for all of them
+ */
+static void run_callbacks(RaCanvas *canvas, bool wait)
+{
+    std::vector<RaCanvasCallback> ready;
+
+    for(auto i = canvas->callbacks.begin(); i != canvas->callbacks.end();) {
+        if(wait ? i->fence.wait(UINT64_MAX) : i->fence.signaled()) {
+            ready.push_back(std::move(*i));
+            i = canvas->callbacks.erase(i);
+        }
+        else {
+            ++i;
+        }
+    }
+
+    // after the list is updated, callbacks may flush again
+    for(RaCanvasCallback &c : ready) {
+        c.callback(c.user_data);
+    }
 }
 
+static HRESULT flush_base(RaCanvas *canvas);
+
 CAPI_FUNC(HRESULT) RaCanvas_Flush(RaCanvas *canvas)
 {
+    run_callbacks(canvas, false);
+
+    HRESULT result = flush_base(canvas);
+
+    for(auto &layer : canvas->layers) {
+        flush_layer(canvas, *layer);
+    }
+
+    return result;
+}
+
+CAPI_FUNC(RaFence*) RaCanvas_FlushAsync(RaCanvas *canvas, RaFenceCallback callback,
+        void *user_data)
+{
+    if(!canvas) {
+        c_error(E_INVALIDARG, "canvas is NULL");
+        return NULL;
+    }
+
+    if(FAILED(RaCanvas_Flush(canvas))) {
+        return NULL;
+    }
+
+    RaFence *fence = new RaFence();
+    fence->insert();
+
+    if(callback) {
+        canvas->callbacks.push_back({RaFence{}, callback, user_data});
+        canvas->callbacks.back().fence.insert();
+    }
+
+    // get the fences to the GPU, polling does not flush, so a fence that
+    // is only ever polled might never be signaled otherwise
+    GL::Renderer::flush();
+
+    return fence;
+}
+
+static HRESULT flush_base(RaCanvas *canvas)
+{
+    // frames of a threaded canvas are published by the producer, and
+    // uploaded when the canvas is drawn
+    if(canvas->threaded) {
+        return S_OK;
+    }
+
+    if(canvas->tiled) {
+        // the recording knows exactly what it touched
+        RaRect ink = canvas->tiled->rasterize(canvas->surface);
+        canvas->damage.add(ink.x, ink.y, ink.w, ink.h);
+        canvas->cr = canvas->tiled->cr();
+    }
+
+    if(canvas->persistent) {
+        HRESULT result = canvas->persistent->flush(canvas->texture, canvas->upload_stats);
+        canvas->surface = canvas->persistent->surface();
+        if(!canvas->tiled) {
+            canvas->cr = canvas->persistent->cr();
+        }
+        canvas->damage.clear();
+        return result;
+    }
+
     // flush all the drawing commands
     cairo_surface_flush(canvas->surface);
 
-    const void *data = cairo_image_surface_get_data(canvas->surface);
+    if(canvas->hashes) {
+        // whatever cairo drew, marked dirty or not, only the tiles whose
+        // content changed are uploaded
+        RaRect all = {0, 0, canvas->width, canvas->height};
+        const RaRect *rects = &all;
+        int count = 1;
 
-    int width = cairo_image_surface_get_width (canvas->surface);
+        if(canvas->track_damage) {
+            rects = canvas->damage.rects().data();
+            count = (int)canvas->damage.rects().size();
+        }
 
-    int height = cairo_image_surface_get_height(canvas->surface);
+        std::vector<RaRect> changed;
+        canvas->hashes->diff(RaUpload_SurfaceSource(canvas->surface), rects, count,
+                changed, canvas->upload_stats.skipped_bytes);
 
-    Containers::ArrayView av{data, (unsigned)(width * height * 4)};
+        upload_rects(canvas, canvas->texture, canvas->surface, canvas->mips.get(),
+                changed.data(), (int)changed.size());
 
-    ImageView2D iv{GL::PixelFormat::BGRA, GL::PixelType::UnsignedByte, {width, height}, av};
+        canvas->damage.clear();
+        return S_OK;
+    }
 
-    canvas->texture.setSubImage(0, {}, iv);
+    if(!canvas->track_damage) {
+        int width = cairo_image_surface_get_width (canvas->surface);
+
+        int height = cairo_image_surface_get_height(canvas->surface);
+
+        RaRect all = {0, 0, width, height};
+
+        upload_rects(canvas, canvas->texture, canvas->surface, canvas->mips.get(), &all, 1);
+
+        return S_OK;
+    }
+
+    const std::vector<RaRect> &rects = canvas->damage.rects();
+
+    upload_rects(canvas, canvas->texture, canvas->surface, canvas->mips.get(),
+            rects.data(), (int)rects.size());
+
+    canvas->damage.clear();
+
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_MarkDirty(RaCanvas *canvas, int x, int y, int w, int h)
+{
+    if(!canvas) {
+        return c_error(E_INVALIDARG, "canvas is NULL");
+    }
+
+    canvas->track_damage = true;
+    canvas->damage.add(x, y, w, h);
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_MarkAllDirty(RaCanvas *canvas)
+{
+    if(!canvas) {
+        return c_error(E_INVALIDARG, "canvas is NULL");
+    }
+
+    canvas->damage.addAll();
+    return S_OK;
+}
+
+CAPI_FUNC(int) RaCanvas_AddLayer(RaCanvas *canvas)
+{
+    if(!canvas) {
+        c_error(E_INVALIDARG, "canvas is NULL");
+        return -1;
+    }
+
+    canvas->layers.emplace_back(new RaCanvasLayer(canvas->width, canvas->height,
+                (canvas->flags & RA_CANVAS_MIPMAPPED) != 0));
+
+    return (int)canvas->layers.size();
+}
+
+CAPI_FUNC(int) RaCanvas_LayerCount(RaCanvas *canvas)
+{
+    return canvas ? (int)canvas->layers.size() + 1 : 0;
+}
+
+CAPI_FUNC(cairo_surface_t*) RaCanvas_LayerSurface(RaCanvas *canvas, int layer)
+{
+    if(canvas && layer == 0) {
+        return RaCanvas_Surface(canvas);
+    }
+
+    RaCanvasLayer *l = get_layer(canvas, layer);
+    if(!l) {
+        c_error(E_INVALIDARG, "invalid canvas layer");
+        return NULL;
+    }
+    return l->surface;
+}
+
+CAPI_FUNC(cairo_t*) RaCanvas_LayerCairo(RaCanvas *canvas, int layer)
+{
+    if(canvas && layer == 0) {
+        return RaCanvas_Cairo(canvas);
+    }
+
+    RaCanvasLayer *l = get_layer(canvas, layer);
+    if(!l) {
+        c_error(E_INVALIDARG, "invalid canvas layer");
+        return NULL;
+    }
+    return l->cr;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_InvalidateLayer(RaCanvas *canvas, int layer)
+{
+    if(canvas && layer == 0) {
+        return RaCanvas_MarkAllDirty(canvas);
+    }
+
+    RaCanvasLayer *l = get_layer(canvas, layer);
+    if(!l) {
+        return c_error(E_INVALIDARG, "invalid canvas layer");
+    }
+
+    l->dirty = true;
+    l->damage.addAll();
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_MarkLayerDirty(RaCanvas *canvas, int layer,
+        int x, int y, int w, int h)
+{
+    if(canvas && layer == 0) {
+        return RaCanvas_MarkDirty(canvas, x, y, w, h);
+    }
+
+    RaCanvasLayer *l = get_layer(canvas, layer);
+    if(!l) {
+        return c_error(E_INVALIDARG, "invalid canvas layer");
+    }
+
+    l->dirty = true;
+    l->track_damage = true;
+    l->damage.add(x, y, w, h);
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_SetLayerVisible(RaCanvas *canvas, int layer, int visible)
+{
+    RaCanvasLayer *l = get_layer(canvas, layer);
+    if(!l) {
+        return c_error(E_INVALIDARG, "invalid canvas layer, the base can not be hidden");
+    }
+
+    l->visible = visible != 0;
+    return S_OK;
+}
+
+CAPI_FUNC(cairo_t*) RaCanvas_BeginCached(RaCanvas *canvas, uint64_t key)
+{
+    if(!canvas) {
+        c_error(E_INVALIDARG, "canvas is NULL");
+        return NULL;
+    }
+
+    cairo_matrix_t matrix;
+    cairo_get_matrix(RaCanvas_Cairo(canvas), &matrix);
+
+    return canvas->cache.begin(key, matrix, canvas->width, canvas->height);
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_EndCached(RaCanvas *canvas, uint64_t key)
+{
+    if(!canvas) {
+        return c_error(E_INVALIDARG, "canvas is NULL");
+    }
+
+    return canvas->cache.end(key, RaCanvas_Cairo(canvas));
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_InvalidateCached(RaCanvas *canvas, uint64_t key)
+{
+    if(!canvas) {
+        return c_error(E_INVALIDARG, "canvas is NULL");
+    }
+
+    canvas->cache.invalidate(key);
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_ClearCache(RaCanvas *canvas)
+{
+    if(!canvas) {
+        return c_error(E_INVALIDARG, "canvas is NULL");
+    }
+
+    canvas->cache.clear();
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_SetUploadBuffers(RaCanvas *canvas, int count)
+{
+    if(!canvas || count < 0) {
+        return c_error(E_INVALIDARG, "invalid canvas or upload buffer count");
+    }
+
+    if(count == 0) {
+        canvas->upload.reset();
+    }
+    else if(!canvas->upload || canvas->upload->slots() != count) {
+        canvas->upload.reset(new RaUploadRing(count));
+    }
+
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvas_SetContentHashing(RaCanvas *canvas, int tile_size)
+{
+    if(!canvas || tile_size < 0) {
+        return c_error(E_INVALIDARG, "invalid canvas or tile size");
+    }
+
+    if(tile_size > 0 && tile_size < 8) {
+        return c_error(E_INVALIDARG, "tile size must be at least 8 pixels");
+    }
+
+    canvas->hash_tile_size = tile_size;
+
+    if(tile_size == 0 || !canvas->pixels) {
+        canvas->hashes.reset();
+    }
+    else if(!canvas->hashes || canvas->hashes->tileSize() != tile_size) {
+        // nothing is known about the texture content yet, the first flush
+        // uploads every tile it hashes
+        canvas->hashes.reset(new RaTileHashes(canvas->width, canvas->height, tile_size));
+    }
 
     return S_OK;
 }
 
+CAPI_FUNC(HRESULT) RaCanvas_GetUploadStats(RaCanvas *canvas, RaUploadStats *stats)
+{
+    if(!canvas || !stats) {
+        return c_error(E_INVALIDARG, "canvas or stats is NULL");
+    }
+
+    *stats = canvas->upload_stats;
+    return S_OK;
+}
+
 
 HRESULT RaCanvas::draw()
 {
     using namespace Math::Literals;
 
+    RaGlState &state = RaGlRegistry::current().state();
+
+    // callbacks are user code, that may change the GL state
+    if(!callbacks.empty()) {
+        run_callbacks(this, false);
+        state.invalidate();
+    }
+
+    if(threaded) {
+        // the latest complete frame, if the producer published a new one
+        if(cairo_surface_t *frame = threaded->consume()) {
+            RaRect all = {0, 0, width, height};
+            upload_rects(this, texture, frame, mips.get(), &all, 1);
+        }
+    }
+
+    state.setBlending(false);
+
+    // the pooled texture can be larger than the canvas
     shader
-        //.setColor(0xffb2b2_rgbf)
-        .bindTexture(texture)
-        .draw(mesh);
+        //->setColor(0xffb2b2_rgbf)
+        ->setTextureScale({float(width)/storage_width, float(height)/storage_height})
+        .setAlphaBlending(false)
+        .bindTexture(state, texture);
+    state.draw(*shader, *mesh);
+
+    if(layers.empty()) {
+        return S_OK;
+    }
+
+    // cairo surfaces are premultiplied
+    state.setBlending(true);
+    state.setBlendFunction(GL::Renderer::BlendFunction::One,
+            GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+
+    shader->setAlphaBlending(true);
+
+    for(auto &layer : layers) {
+        if(layer->visible) {
+            shader->bindTexture(state, layer->texture);
+            state.draw(*shader, *mesh);
+        }
+    }
 
     return S_OK;
 }
@@ -13,16 +13,177 @@
 #include <Magnum/SceneGraph/Object.h>
 #include <Magnum/GL/Mesh.h>
 #include <TexturedTriangleShader.h>
+#include "ra_damage.hpp"
+#include "ra_upload.hpp"
+#include "ra_persistent_surface.hpp"
+#include "ra_tiled_surface.hpp"
+#include "ra_canvas_cache.hpp"
+#include "ra_surface_pool.hpp"
+#include "ra_mipmap.hpp"
+#include "ra_threaded_surface.hpp"
+#include "ra_tile_hash.hpp"
+#include "ra_gl_registry.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * A layer drawn over the base surface of a canvas, with its own surface,
+ * texture and dirty state, so it is only uploaded when it changes.
+ */
+struct RaCanvasLayer {
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    Magnum::GL::Texture2D texture{Magnum::NoCreate};
+
+    /**
+     * pooled memory of the surface, and the size of the pool bucket it
+     * and the texture came from.
+     */
+    unsigned char *pixels;
+    int storage_width;
+    int storage_height;
+
+    /**
+     * lower mip levels, if the canvas is mipmapped
+     */
+    std::unique_ptr<RaMipChain> mips;
+
+    RaDamage damage;
+
+    /**
+     * same as the canvas, set once a region of the layer is marked dirty.
+     */
+    bool track_damage;
+
+    /**
+     * changed since the last flush
+     */
+    bool dirty;
+
+    bool visible;
+
+    RaCanvasLayer(int width, int height, bool mipmapped);
+
+    /**
+     * gives the surface memory and texture back to the pool
+     */
+
+    ~RaCanvasLayer();
+};
+
+/**
+ * a callback of RaCanvas_FlushAsync, waiting for its fence
+ */
+struct RaCanvasCallback {
+    RaFence fence;
+    RaFenceCallback callback;
+    void *user_data;
+};
 
 struct RaCanvas {
-    Magnum::GL::Mesh mesh;
-    Magnum::Examples::TexturedTriangleShader shader;
-    Magnum::GL::Texture2D texture;
+    /**
+     * the quad and program of the context, shared with the other canvases.
+     */
+    std::shared_ptr<Magnum::GL::Mesh> mesh;
+    std::shared_ptr<Magnum::Examples::TexturedTriangleShader> shader;
+    Magnum::GL::Texture2D texture{Magnum::NoCreate};
     cairo_surface_t *surface;
     cairo_t *cr;
 
     /**
-     * draw the canvas to the current context, does not swap buffers.
+     * window the canvas is attached to, and the RaCanvasFlags it was
+     * created with.
+     */
+    RaWindow *window;
+    uint32_t flags;
+
+    int width;
+    int height;
+
+    /**
+     * size of the pool bucket the texture and pixels came from, at least
+     * width x height, pixels is NULL for persistent canvases.
+     */
+    int storage_width;
+    int storage_height;
+    unsigned char *pixels;
+
+    /**
+     * lower mip levels of the texture, updated on flush from the dirty
+     * rects, if the canvas was created with RA_CANVAS_MIPMAPPED.
+     */
+    std::unique_ptr<RaMipChain> mips;
+
+    /**
+     * regions changed since the last flush.
+     */
+    RaDamage damage;
+
+    /**
+     * set once the user starts marking dirty regions, until then, every
+     * flush uploads the whole surface.
+     */
+    bool track_damage;
+
+    /**
+     * ring of upload buffers, null for synchronous uploads from the
+     * surface memory.
+     */
+    std::unique_ptr<RaUploadRing> upload;
+
+    RaUploadStats upload_stats;
+
+    /**
+     * tile size for content hashing, 0 if disabled, and the hashes of the
+     * last flushed frame. Only canvases that draw into client memory are
+     * hashed, hashes is null for persistent and threaded canvases.
+     */
+    int hash_tile_size;
+    std::unique_ptr<RaTileHashes> hashes;
+
+    /**
+     * persistently mapped buffers that cairo draws into directly, if the
+     * canvas was created with RA_CANVAS_PERSISTENT. surface and cr always
+     * point to the current buffer.
+     */
+    std::unique_ptr<RaPersistentSurface> persistent;
+
+    /**
+     * records drawing and rasterizes it in parallel tiles into surface
+     * on flush, if the canvas was created with RA_CANVAS_TILED. cr is then
+     * the recording's cairo object.
+     */
+    std::unique_ptr<RaTiledSurface> tiled;
+
+    /**
+     * surfaces a producer thread draws into, if the canvas was created
+     * with RA_CANVAS_THREADED. surface and cr are then NULL, the producer
+     * gets its own through RaCanvas_Surface and RaCanvas_Cairo.
+     */
+    std::unique_ptr<RaThreadedSurface> threaded;
+
+    /**
+     * rasterized blocks of static content, see RaCanvas_BeginCached.
+     */
+    RaCanvasCache cache;
+
+    /**
+     * layers above the base surface, in drawing order, layer n in the API
+     * is layers[n - 1].
+     */
+    std::vector<std::unique_ptr<RaCanvasLayer>> layers;
+
+    /**
+     * pending callbacks of async flushes, checked without blocking on
+     * every flush and draw.
+     */
+    std::vector<RaCanvasCallback> callbacks;
+
+    /**
+     * draw the canvas to the current context, does not swap buffers. The
+     * base surface is drawn opaque, and the layers are alpha blended over
+     * it in order. Threaded canvases first upload the latest frame of the
+     * producer, if there is a new one.
      */
     HRESULT draw();
 };
@@ -0,0 +1,340 @@
+/*
+ * ra_canvas_batch.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_canvas_batch.hpp"
+#include <ra_window.hpp>
+
+#include "ra_upload.hpp"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/TextureFormat.h>
+
+#include <algorithm>
+
+using namespace Magnum;
+using namespace Magnum::Examples;
+
+namespace {
+
+struct Instance {
+    Matrix4 transformation;
+    Float layer;
+    Vector4 textureRect;
+};
+
+}
+
+static RaCanvasBatchSlot *get_slot(RaCanvasBatch *batch, int index)
+{
+    if(!batch || index < 0 || index >= (int)batch->slots.size() || !batch->slots[index].used) {
+        return NULL;
+    }
+    return &batch->slots[index];
+}
+
+/**
+ * makes a texture array with room for capacity canvases, everything is
+ * uploaded again on the next flush.
+ */
+static void create_texture(RaCanvasBatch *batch, int capacity)
+{
+    batch->texture = GL::Texture2DArray{};
+    batch->texture.setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setMagnificationFilter(GL::SamplerFilter::Linear)
+        .setMinificationFilter(GL::SamplerFilter::Linear)
+        .setStorage(1, GL::TextureFormat::RGBA8, {batch->width, batch->height, capacity});
+
+    batch->capacity = capacity;
+
+    for(RaCanvasBatchSlot &slot : batch->slots) {
+        if(slot.used) {
+            slot.dirty = true;
+            slot.damage.addAll();
+        }
+    }
+}
+
+CAPI_FUNC(RaCanvasBatch*) RaCanvasBatch_Create(RaWindow *win, int width, int height)
+{
+    if(!win) {
+        c_error(E_INVALIDARG, "window is NULL");
+        return NULL;
+    }
+
+    if(width <= 0 || height <= 0) {
+        c_error(E_INVALIDARG, "canvas size must be positive");
+        return NULL;
+    }
+
+    RaCanvasBatch *result = new RaCanvasBatch();
+
+    result->window = win;
+    result->width = width;
+    result->height = height;
+    result->count = 0;
+    result->instances_dirty = true;
+    result->upload_stats = {};
+
+    create_texture(result, 4);
+
+    RaGlRegistry &registry = RaGlRegistry::current();
+    result->quad = registry.quadBuffer();
+    result->shader = registry.batchShader();
+
+    result->mesh.setCount(4)
+        .setPrimitive(GL::MeshPrimitive::TriangleStrip)
+        .addVertexBuffer(*result->quad, 0,
+            CanvasBatchShader::Position{},
+            CanvasBatchShader::TextureCoordinates{})
+        .addVertexBufferInstanced(result->instances, 1, 0,
+            CanvasBatchShader::Transformation{},
+            CanvasBatchShader::Layer{},
+            CanvasBatchShader::TextureRect{});
+
+    win->batches.push_back(result);
+
+    return result;
+}
+
+CAPI_FUNC(HRESULT) RaCanvasBatch_Destroy(RaCanvasBatch *batch)
+{
+    if(!batch) {
+        return c_error(E_INVALIDARG, "batch is NULL");
+    }
+
+    for(RaCanvasBatchSlot &slot : batch->slots) {
+        if(slot.used) {
+            cairo_destroy(slot.cr);
+            cairo_surface_destroy(slot.surface);
+        }
+    }
+
+    std::vector<RaCanvasBatch*> &batches = batch->window->batches;
+    batches.erase(std::remove(batches.begin(), batches.end(), batch), batches.end());
+
+    delete batch;
+    return S_OK;
+}
+
+CAPI_FUNC(int) RaCanvasBatch_Add(RaCanvasBatch *batch)
+{
+    if(!batch) {
+        c_error(E_INVALIDARG, "batch is NULL");
+        return -1;
+    }
+
+    int index;
+    if(!batch->free_slots.empty()) {
+        index = batch->free_slots.back();
+        batch->free_slots.pop_back();
+    }
+    else {
+        index = (int)batch->slots.size();
+
+        if(index >= batch->capacity) {
+            int max = GL::Texture2DArray::maxSize().z();
+            if(index >= max) {
+                c_error(E_FAIL, "canvas batch is at the maximum number of texture array layers");
+                return -1;
+            }
+            create_texture(batch, std::min(max, batch->capacity * 2));
+        }
+
+        batch->slots.emplace_back();
+    }
+
+    RaCanvasBatchSlot &slot = batch->slots[index];
+    slot.surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, batch->width, batch->height);
+    slot.cr = cairo_create(slot.surface);
+    slot.damage.setBounds(batch->width, batch->height);
+    slot.damage.addAll();
+    slot.used = true;
+    slot.dirty = true;
+    slot.visible = true;
+    slot.transformation = Matrix4{Math::IdentityInit};
+
+    batch->count += 1;
+    batch->instances_dirty = true;
+
+    return index;
+}
+
+CAPI_FUNC(HRESULT) RaCanvasBatch_Remove(RaCanvasBatch *batch, int index)
+{
+    RaCanvasBatchSlot *slot = get_slot(batch, index);
+    if(!slot) {
+        return c_error(E_INVALIDARG, "invalid canvas index");
+    }
+
+    cairo_destroy(slot->cr);
+    cairo_surface_destroy(slot->surface);
+    slot->cr = NULL;
+    slot->surface = NULL;
+    slot->used = false;
+
+    batch->free_slots.push_back(index);
+    batch->count -= 1;
+    batch->instances_dirty = true;
+
+    return S_OK;
+}
+
+CAPI_FUNC(int) RaCanvasBatch_Count(RaCanvasBatch *batch)
+{
+    return batch ? batch->count : 0;
+}
+
+CAPI_FUNC(cairo_surface_t*) RaCanvasBatch_Surface(RaCanvasBatch *batch, int index)
+{
+    RaCanvasBatchSlot *slot = get_slot(batch, index);
+    if(!slot) {
+        c_error(E_INVALIDARG, "invalid canvas index");
+        return NULL;
+    }
+    return slot->surface;
+}
+
+CAPI_FUNC(cairo_t*) RaCanvasBatch_Cairo(RaCanvasBatch *batch, int index)
+{
+    RaCanvasBatchSlot *slot = get_slot(batch, index);
+    if(!slot) {
+        c_error(E_INVALIDARG, "invalid canvas index");
+        return NULL;
+    }
+    return slot->cr;
+}
+
+CAPI_FUNC(HRESULT) RaCanvasBatch_SetTransform(RaCanvasBatch *batch, int index,
+        const float *matrix)
+{
+    RaCanvasBatchSlot *slot = get_slot(batch, index);
+    if(!slot || !matrix) {
+        return c_error(E_INVALIDARG, "invalid canvas index or matrix");
+    }
+
+    for(int col = 0; col < 4; ++col) {
+        for(int row = 0; row < 4; ++row) {
+            slot->transformation[col][row] = matrix[col * 4 + row];
+        }
+    }
+
+    batch->instances_dirty = true;
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvasBatch_SetVisible(RaCanvasBatch *batch, int index, int visible)
+{
+    RaCanvasBatchSlot *slot = get_slot(batch, index);
+    if(!slot) {
+        return c_error(E_INVALIDARG, "invalid canvas index");
+    }
+
+    slot->visible = visible != 0;
+    batch->instances_dirty = true;
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvasBatch_MarkDirty(RaCanvasBatch *batch, int index,
+        int x, int y, int w, int h)
+{
+    RaCanvasBatchSlot *slot = get_slot(batch, index);
+    if(!slot) {
+        return c_error(E_INVALIDARG, "invalid canvas index");
+    }
+
+    slot->dirty = true;
+    slot->damage.add(x, y, w, h);
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvasBatch_Invalidate(RaCanvasBatch *batch, int index)
+{
+    RaCanvasBatchSlot *slot = get_slot(batch, index);
+    if(!slot) {
+        return c_error(E_INVALIDARG, "invalid canvas index");
+    }
+
+    slot->dirty = true;
+    slot->damage.addAll();
+    return S_OK;
+}
+
+/**
+ * copies the damaged rects of a slot to its layer, straight from the
+ * surface memory.
+ */
+static void upload_slot(RaCanvasBatch *batch, int index, RaCanvasBatchSlot &slot)
+{
+    cairo_surface_flush(slot.surface);
+
+    const std::vector<RaRect> &rects = slot.damage.rects();
+    RaUpload_DirectLayer(batch->texture, index, RaUpload_SurfaceSource(slot.surface),
+            rects.data(), (int)rects.size(), batch->upload_stats);
+
+    slot.damage.clear();
+    slot.dirty = false;
+}
+
+CAPI_FUNC(HRESULT) RaCanvasBatch_Flush(RaCanvasBatch *batch)
+{
+    if(!batch) {
+        return c_error(E_INVALIDARG, "batch is NULL");
+    }
+
+    for(int i = 0; i < (int)batch->slots.size(); ++i) {
+        RaCanvasBatchSlot &slot = batch->slots[i];
+        if(slot.used && slot.dirty) {
+            upload_slot(batch, i, slot);
+        }
+    }
+
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaCanvasBatch_GetUploadStats(RaCanvasBatch *batch, RaUploadStats *stats)
+{
+    if(!batch || !stats) {
+        return c_error(E_INVALIDARG, "batch or stats is NULL");
+    }
+
+    *stats = batch->upload_stats;
+    return S_OK;
+}
+
+HRESULT RaCanvasBatch::draw()
+{
+    if(instances_dirty) {
+        std::vector<Instance> data;
+        data.reserve(count);
+
+        for(int i = 0; i < (int)slots.size(); ++i) {
+            if(slots[i].used && slots[i].visible) {
+                data.push_back({slots[i].transformation, Float(i), {0.0f, 0.0f, 1.0f, 1.0f}});
+            }
+        }
+
+        instances.setData(Containers::arrayView(data), GL::BufferUsage::DynamicDraw);
+        mesh.setInstanceCount((Int)data.size());
+        instances_dirty = false;
+    }
+
+    if(mesh.instanceCount() == 0) {
+        return S_OK;
+    }
+
+    RaGlState &state = RaGlRegistry::current().state();
+
+    state.setBlending(true);
+    state.setBlendFunction(GL::Renderer::BlendFunction::One,
+            GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+
+    shader->bindTexture(state, texture);
+    state.draw(*shader, mesh);
+
+    return S_OK;
+}
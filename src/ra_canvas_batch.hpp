@@ -0,0 +1,84 @@
+/*
+ * ra_canvas_batch.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_CANVAS_BATCH_HPP_
+#define SRC_RA_CANVAS_BATCH_HPP_
+
+#include <ra_canvas_batch.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/TextureArray.h>
+#include <Magnum/Math/Matrix4.h>
+#include <CanvasBatchShader.h>
+#include "ra_damage.hpp"
+#include "ra_gl_registry.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * A canvas of a batch, stored in the layer of the texture array with the
+ * same index.
+ */
+struct RaCanvasBatchSlot {
+    cairo_surface_t *surface;
+    cairo_t *cr;
+
+    RaDamage damage;
+
+    bool used;
+    bool dirty;
+    bool visible;
+
+    Magnum::Matrix4 transformation;
+};
+
+struct RaCanvasBatch {
+    RaWindow *window;
+
+    int width;
+    int height;
+
+    /**
+     * one layer per slot, capacity layers.
+     */
+    Magnum::GL::Texture2DArray texture{Magnum::NoCreate};
+    int capacity;
+
+    std::vector<RaCanvasBatchSlot> slots;
+
+    /**
+     * indices of removed slots, reused before adding new ones.
+     */
+    std::vector<int> free_slots;
+
+    int count;
+
+    /**
+     * the quad of the context, referenced by the mesh, and the program,
+     * shared with the other batches and atlases.
+     */
+    std::shared_ptr<Magnum::GL::Buffer> quad;
+    Magnum::GL::Mesh mesh;
+    std::shared_ptr<Magnum::Examples::CanvasBatchShader> shader;
+
+    /**
+     * transformation and layer of each visible canvas, rebuilt before
+     * drawing when a canvas was added, removed, moved, shown or hidden.
+     */
+    Magnum::GL::Buffer instances;
+    bool instances_dirty;
+
+    RaUploadStats upload_stats;
+
+    /**
+     * draws all the visible canvases in one instanced call, alpha blended
+     * in index order.
+     */
+    HRESULT draw();
+};
+
+#endif /* SRC_RA_CANVAS_BATCH_HPP_ */
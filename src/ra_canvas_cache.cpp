@@ -0,0 +1,140 @@
+/*
+ * ra_canvas_cache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_canvas_cache.hpp"
+#include <carbon.h>
+
+#include <algorithm>
+#include <cmath>
+
+static void release_entry(cairo_surface_t *&image, cairo_surface_t *&recording, cairo_t *&cr)
+{
+    if(cr) {
+        cairo_destroy(cr);
+        cr = nullptr;
+    }
+    if(recording) {
+        cairo_surface_destroy(recording);
+        recording = nullptr;
+    }
+    if(image) {
+        cairo_surface_destroy(image);
+        image = nullptr;
+    }
+}
+
+static bool same_matrix(const cairo_matrix_t &a, const cairo_matrix_t &b)
+{
+    return a.xx == b.xx && a.yx == b.yx && a.xy == b.xy &&
+           a.yy == b.yy && a.x0 == b.x0 && a.y0 == b.y0;
+}
+
+RaCanvasCache::~RaCanvasCache()
+{
+    clear();
+}
+
+cairo_t *RaCanvasCache::begin(uint64_t key, const cairo_matrix_t &matrix, int width, int height)
+{
+    if(_active) {
+        c_error(E_FAIL, "a cached block is already being drawn");
+        return nullptr;
+    }
+
+    Entry &e = _entries[key];
+
+    if(e.image && e.width == width && e.height == height && same_matrix(e.matrix, matrix)) {
+        _active = &e;
+        _activeKey = key;
+        return nullptr;
+    }
+
+    release_entry(e.image, e.recording, e.cr);
+
+    e.matrix = matrix;
+    e.width = width;
+    e.height = height;
+
+    cairo_rectangle_t extents = {0, 0, (double)width, (double)height};
+    e.recording = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+    e.cr = cairo_create(e.recording);
+
+    // the block is drawn in the same user space as the canvas
+    cairo_set_matrix(e.cr, &matrix);
+
+    _active = &e;
+    _activeKey = key;
+
+    return e.cr;
+}
+
+HRESULT RaCanvasCache::end(uint64_t key, cairo_t *target)
+{
+    if(!_active || key != _activeKey) {
+        return c_error(E_FAIL, "no cached block with this key is being drawn");
+    }
+
+    Entry &e = *_active;
+    _active = nullptr;
+
+    if(e.recording) {
+        cairo_surface_flush(e.recording);
+
+        double ix, iy, iw, ih;
+        cairo_recording_surface_ink_extents(e.recording, &ix, &iy, &iw, &ih);
+
+        int x0 = std::max(0, (int)std::floor(ix));
+        int y0 = std::max(0, (int)std::floor(iy));
+        int x1 = std::min(e.width, (int)std::ceil(ix + iw));
+        int y1 = std::min(e.height, (int)std::ceil(iy + ih));
+
+        // rasterize only what the block touched
+        e.x = x0;
+        e.y = y0;
+        e.image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                std::max(1, x1 - x0), std::max(1, y1 - y0));
+
+        cairo_t *cr = cairo_create(e.image);
+        cairo_set_source_surface(cr, e.recording, -x0, -y0);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+
+        cairo_destroy(e.cr);
+        e.cr = nullptr;
+        cairo_surface_destroy(e.recording);
+        e.recording = nullptr;
+    }
+
+    // the raster is in device space, blit it without the canvas transform
+    cairo_save(target);
+    cairo_identity_matrix(target);
+    cairo_set_source_surface(target, e.image, e.x, e.y);
+    cairo_paint(target);
+    cairo_restore(target);
+
+    return S_OK;
+}
+
+void RaCanvasCache::invalidate(uint64_t key)
+{
+    auto i = _entries.find(key);
+    if(i == _entries.end() || &i->second == _active) {
+        return;
+    }
+
+    release_entry(i->second.image, i->second.recording, i->second.cr);
+    _entries.erase(i);
+}
+
+void RaCanvasCache::clear()
+{
+    for(auto &i : _entries) {
+        release_entry(i.second.image, i.second.recording, i.second.cr);
+    }
+    _entries.clear();
+    _active = nullptr;
+}
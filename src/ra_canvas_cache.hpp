@@ -0,0 +1,84 @@
+/*
+ * ra_canvas_cache.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_CANVAS_CACHE_HPP_
+#define SRC_RA_CANVAS_CACHE_HPP_
+
+#include <cairo.h>
+#include <c_port.h>
+#include <stdint.h>
+#include <unordered_map>
+
+/**
+ * Keeps rasterized copies of drawing blocks that rarely change, i.e. axes,
+ * grids and legends.
+ *
+ * A block is recorded once into a cairo recording surface, rasterized into
+ * an image surface the size of what it touched, and from then on painting
+ * it is a single blit of that image. The raster is redone only when the
+ * key is invalidated, or the canvas size or transform changes.
+ */
+class RaCanvasCache {
+public:
+
+    RaCanvasCache(): _active{nullptr}, _activeKey{0} {}
+
+    ~RaCanvasCache();
+
+    RaCanvasCache(const RaCanvasCache&) = delete;
+    RaCanvasCache& operator=(const RaCanvasCache&) = delete;
+
+    /**
+     * Starts a cached block drawn with the given transform on a canvas of
+     * the given size.
+     *
+     * @returns a cairo object to record the block into if the cached raster
+     * is missing or stale, NULL if the cached raster can be used as is.
+     */
+    cairo_t *begin(uint64_t key, const cairo_matrix_t &matrix, int width, int height);
+
+    /**
+     * ends the block, rasterizes it if it was recorded, and paints the
+     * raster onto target.
+     */
+    HRESULT end(uint64_t key, cairo_t *target);
+
+    /**
+     * is a block started and not ended yet.
+     */
+    bool active() const { return _active != nullptr; }
+
+    void invalidate(uint64_t key);
+
+    void clear();
+
+private:
+    struct Entry {
+        cairo_matrix_t matrix = {};
+        int width = 0;
+        int height = 0;
+
+        /**
+         * raster of what the block touched, and its position in the canvas
+         */
+        cairo_surface_t *image = nullptr;
+        int x = 0;
+        int y = 0;
+
+        /**
+         * recording in progress, between begin and end
+         */
+        cairo_surface_t *recording = nullptr;
+        cairo_t *cr = nullptr;
+    };
+
+    std::unordered_map<uint64_t, Entry> _entries;
+    Entry *_active;
+    uint64_t _activeKey;
+};
+
+#endif /* SRC_RA_CANVAS_CACHE_HPP_ */
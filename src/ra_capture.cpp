@@ -0,0 +1,399 @@
+/*
+ * ra_capture.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_capture.hpp"
+#include "ra_window.hpp"
+#include <carbon.h>
+#include <ra_upload.h>
+
+#include <cctype>
+
+typedef std::chrono::steady_clock Clock;
+
+static uint64_t nanoseconds(Clock::duration time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+/**
+ * the capture and frame number an AVI frame's JPEG goes to
+ */
+struct RaCaptureFrame {
+    RaCapture *capture;
+    uint64_t index;
+};
+
+/**
+ * splits an image sequence path around its frame number conversion, %d
+ * or %0Nd for N zero padded digits, the only conversion allowed, %% is a
+ * literal %.
+ *
+ * @returns false if there is not exactly one frame number conversion.
+ */
+static bool split_sequence_path(const std::string &path, std::string &prefix,
+        int &digits, std::string &suffix)
+{
+    std::string *part = &prefix;
+    prefix.clear();
+    suffix.clear();
+    digits = 0;
+
+    for(std::size_t i = 0; i < path.size(); ++i) {
+        if(path[i] != '%') {
+            part->push_back(path[i]);
+            continue;
+        }
+
+        if(i + 1 < path.size() && path[i + 1] == '%') {
+            part->push_back('%');
+            i += 1;
+            continue;
+        }
+
+        if(part == &suffix) {
+            return false;
+        }
+
+        std::size_t j = i + 1;
+        if(j < path.size() && path[j] == '0') {
+            j += 1;
+            for(; j < path.size() && std::isdigit((unsigned char)path[j]); ++j) {
+                digits = digits * 10 + (path[j] - '0');
+                if(digits > 20) {
+                    return false;
+                }
+            }
+        }
+
+        if(j >= path.size() || path[j] != 'd') {
+            return false;
+        }
+
+        part = &suffix;
+        i = j;
+    }
+
+    return part == &suffix;
+}
+
+RaCapture::RaCapture(RaWindow *window, const RaCaptureConfig &config, int width, int height):
+    window{window},
+    _format{config.format},
+    _path{config.path},
+    _digits{0},
+    _every{config.every > 0 ? config.every : 1},
+    _policy{config.policy},
+    _ringSize{config.ring_size > 0 ? config.ring_size : 8},
+    _fps{config.fps > 0 ? config.fps : 30},
+    _width{width},
+    _height{height},
+    _next{0},
+    _stats{},
+    _hasLast{false},
+    _written{0},
+    _writtenFrames{0},
+    _writtenBytes{0},
+    _writeDropped{0},
+    _stop{false}
+{
+    _encoder.reset(new RaJpegEncoder(config.threads, _ringSize,
+            config.quality > 0 ? config.quality : 90));
+
+    if(_format == RA_CAPTURE_JPEG_SEQUENCE) {
+        split_sequence_path(_path, _prefix, _digits, _suffix);
+    }
+}
+
+RaCapture::~RaCapture()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _ready.notify_all();
+    _room.notify_all();
+
+    // workers no longer block on the writer, and finish the queued frames
+    _encoder.reset();
+
+    if(_writer.joinable()) {
+        _writer.join();
+    }
+}
+
+HRESULT RaCapture::start()
+{
+    if(_format != RA_CAPTURE_MJPEG_AVI) {
+        return S_OK;
+    }
+
+    HRESULT result = _avi.open(_path.c_str(), _width, _height, _fps);
+    if(FAILED(result)) {
+        return result;
+    }
+
+    _writer = std::thread(&RaCapture::run, this);
+    return S_OK;
+}
+
+void RaCapture::frame()
+{
+    Clock::time_point start = Clock::now();
+
+    if(_hasLast) {
+        _stats.frame_ns += nanoseconds(start - _last);
+    }
+    _last = start;
+    _hasLast = true;
+
+    const bool take = _stats.frames % _every == 0;
+    _stats.frames += 1;
+
+    if(!take) {
+        return;
+    }
+
+    capture();
+
+    _stats.capture_ns += nanoseconds(Clock::now() - start);
+}
+
+void RaCapture::addTime(Clock::duration time)
+{
+    _stats.capture_ns += nanoseconds(time);
+}
+
+void RaCapture::capture()
+{
+    int width, height;
+    window->framebufferSize(width, height);
+
+    // an AVI has a single frame size
+    if(width <= 0 || height <= 0 ||
+       (_format == RA_CAPTURE_MJPEG_AVI && (width != _width || height != _height))) {
+        _stats.dropped += 1;
+        return;
+    }
+
+    const bool full = _encoder->stats().queued >= _encoder->capacity();
+
+    if(full && _policy == RA_CAPTURE_DROP) {
+        _stats.dropped += 1;
+        return;
+    }
+
+    if(full) {
+        _stats.throttled += 1;
+        _encoder->makeRoom(window);
+    }
+
+    std::unique_ptr<RaJpegEncoder::Frame> frame =
+            _encoder->acquire(width, height, _policy == RA_CAPTURE_THROTTLE);
+
+    if(!frame) {
+        _stats.dropped += 1;
+        return;
+    }
+
+    RaCaptureFrame *encoded = NULL;
+
+    if(_format == RA_CAPTURE_JPEG_SEQUENCE) {
+        std::string number = std::to_string(_next);
+        if((int)number.size() < _digits) {
+            number.insert(0, _digits - number.size(), '0');
+        }
+        frame->path = _prefix + number + _suffix;
+    }
+    else {
+        encoded = new RaCaptureFrame{this, _next};
+        frame->callback = frameEncoded;
+        frame->userData = encoded;
+    }
+
+    if(FAILED(_encoder->readWindow(window, std::move(frame)))) {
+        delete encoded;
+        _stats.dropped += 1;
+        return;
+    }
+
+    _next += 1;
+    _stats.captured += 1;
+}
+
+void RaCapture::frameEncoded(void *userData, HRESULT result, const void *data, size_t size)
+{
+    std::unique_ptr<RaCaptureFrame> frame((RaCaptureFrame*)userData);
+    frame->capture->push(frame->index, SUCCEEDED(result) ? data : NULL,
+            SUCCEEDED(result) ? size : 0);
+}
+
+void RaCapture::push(uint64_t index, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        // the writer is waiting for the next frame, so it always gets in,
+        // frames are handed to the workers in order, so that one is not
+        // held up behind a later frame
+        _room.wait(lock, [&] {
+            return _stop || index == _written || (int)_encoded.size() < _ringSize;
+        });
+
+        _encoded[index] = bytes ? Encoded(bytes, bytes + size) : Encoded();
+    }
+    _ready.notify_one();
+}
+
+void RaCapture::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    for(;;) {
+        _ready.wait(lock, [this] { return _stop || _encoded.count(_written) > 0; });
+
+        auto it = _encoded.find(_written);
+        if(it == _encoded.end()) {
+            return;
+        }
+
+        Encoded jpeg = std::move(it->second);
+        _encoded.erase(it);
+
+        lock.unlock();
+        const bool ok = !jpeg.empty() && _avi.write(jpeg.data(), jpeg.size());
+        lock.lock();
+
+        _written += 1;
+        _writtenFrames += ok ? 1 : 0;
+        _writtenBytes += ok ? jpeg.size() + 8 : 0;
+        _writeDropped += ok ? 0 : 1;
+
+        _room.notify_all();
+    }
+}
+
+HRESULT RaCapture::stop()
+{
+    _encoder->finishReads();
+    _encoder->finish();
+
+    if(_format != RA_CAPTURE_MJPEG_AVI) {
+        return S_OK;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _ready.notify_all();
+    _writer.join();
+
+    return _avi.close();
+}
+
+RaCaptureStats RaCapture::stats()
+{
+    RaCaptureStats result = _stats;
+    RaJpegStats jpeg = _encoder->stats();
+
+    if(_format == RA_CAPTURE_JPEG_SEQUENCE) {
+        result.written = jpeg.frames;
+        result.bytes = jpeg.bytes;
+        result.dropped += jpeg.failed;
+        result.pending = jpeg.queued;
+    }
+    else {
+        std::lock_guard<std::mutex> lock(_mutex);
+        result.written = _writtenFrames;
+        result.bytes = _writtenBytes;
+        result.dropped += _writeDropped;
+        result.pending = jpeg.queued + (int)_encoded.size();
+    }
+
+    result.budget = result.frame_ns ? (float)((double)result.capture_ns / result.frame_ns) : 0;
+    return result;
+}
+
+CAPI_FUNC(RaCapture*) RaCapture_Start(RaWindow *window, const RaCaptureConfig *config)
+{
+    if(!window || !config || !config->path) {
+        c_error(E_INVALIDARG, "window, config or path is NULL");
+        return NULL;
+    }
+
+    if(config->format != RA_CAPTURE_MJPEG_AVI && config->format != RA_CAPTURE_JPEG_SEQUENCE) {
+        c_error(E_INVALIDARG, "invalid capture format");
+        return NULL;
+    }
+
+    std::string prefix, suffix;
+    int digits;
+    if(config->format == RA_CAPTURE_JPEG_SEQUENCE &&
+       !split_sequence_path(config->path, prefix, digits, suffix)) {
+        c_error(E_INVALIDARG, "image sequence path needs exactly one %d or %0Nd conversion");
+        return NULL;
+    }
+
+    if(config->policy != RA_CAPTURE_DROP && config->policy != RA_CAPTURE_THROTTLE) {
+        c_error(E_INVALIDARG, "invalid capture policy");
+        return NULL;
+    }
+
+    if(config->every < 0 || config->ring_size < 0 || config->quality < 0 ||
+       config->quality > 100 || config->fps < 0) {
+        c_error(E_INVALIDARG, "invalid capture config");
+        return NULL;
+    }
+
+    if(window->capture) {
+        c_error(E_FAIL, "window is already being captured");
+        return NULL;
+    }
+
+    int width, height;
+    window->framebufferSize(width, height);
+    if(width <= 0 || height <= 0) {
+        c_error(E_FAIL, "window has no framebuffer to capture");
+        return NULL;
+    }
+
+    std::unique_ptr<RaCapture> capture(new RaCapture(window, *config, width, height));
+
+    if(FAILED(capture->start())) {
+        return NULL;
+    }
+
+    window->capture = capture.get();
+    return capture.release();
+}
+
+CAPI_FUNC(HRESULT) RaCapture_Stop(RaCapture *capture)
+{
+    if(!capture) {
+        return c_error(E_INVALIDARG, "capture is NULL");
+    }
+
+    if(capture->window->capture == capture) {
+        capture->window->capture = NULL;
+    }
+
+    HRESULT result = capture->stop();
+
+    delete capture;
+    return result;
+}
+
+CAPI_FUNC(HRESULT) RaCapture_GetStats(RaCapture *capture, RaCaptureStats *stats)
+{
+    if(!capture || !stats) {
+        return c_error(E_INVALIDARG, "capture or stats is NULL");
+    }
+
+    *stats = capture->stats();
+    return S_OK;
+}
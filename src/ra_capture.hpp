@@ -0,0 +1,148 @@
+/*
+ * ra_capture.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_CAPTURE_HPP_
+#define SRC_RA_CAPTURE_HPP_
+
+#include <ra_capture.h>
+#include "ra_avi_writer.hpp"
+#include "ra_jpeg_encoder.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Records the frames of a window, this is also the RaCapture handle of the
+ * public API.
+ *
+ * Frames go through three stages, each on its own thread: the render
+ * thread reads the framebuffer back into a frame of the JPEG encoder with
+ * the window's pixel-pack buffers, the encoder workers compress it, and
+ * for an AVI, a writer thread appends the JPEGs to the file in frame order.
+ * The encoder has ring_size frames, and at most ring_size JPEGs wait for
+ * the writer, so a slow disk fills the ring, and the render thread drops
+ * frames or waits as the policy says.
+ */
+struct RaCapture {
+public:
+
+    /**
+     * captures frames of width x height, the framebuffer size at start.
+     */
+    RaCapture(RaWindow *window, const RaCaptureConfig &config, int width, int height);
+
+    /**
+     * stops the writer, without waiting for frames in flight, use stop
+     * first to keep them.
+     */
+    ~RaCapture();
+
+    RaCapture(const RaCapture&) = delete;
+    RaCapture& operator=(const RaCapture&) = delete;
+
+    /**
+     * opens the file and starts the writer.
+     */
+    HRESULT start();
+
+    /**
+     * called by the window once a frame is drawn, captures it if it is
+     * one of every Nth frames.
+     */
+    void frame();
+
+    /**
+     * counts time the window spent on capture outside of frame, i.e.
+     * copying reads out of the pixel-pack buffers.
+     */
+    void addTime(std::chrono::steady_clock::duration time);
+
+    /**
+     * delivers the reads in flight, and waits until every frame is
+     * encoded and written, then finishes the file.
+     */
+    HRESULT stop();
+
+    RaCaptureStats stats();
+
+    RaWindow *const window;
+
+private:
+
+    /**
+     * a JPEG of the AVI waiting for the writer, empty if encoding failed.
+     */
+    typedef std::vector<uint8_t> Encoded;
+
+    static void frameEncoded(void *userData, HRESULT result, const void *data, size_t size);
+
+    /**
+     * hands the JPEG of frame index to the writer, blocks while the writer
+     * is ring_size frames behind.
+     */
+    void push(uint64_t index, const void *data, size_t size);
+
+    void run();
+
+    void capture();
+
+    const uint32_t _format;
+    const std::string _path;
+
+    /**
+     * an image sequence path split around its frame number, which is
+     * padded with zeros to _digits
+     */
+    std::string _prefix;
+    std::string _suffix;
+    int _digits;
+    const int _every;
+    const uint32_t _policy;
+    const int _ringSize;
+    const double _fps;
+    const int _width;
+    const int _height;
+
+    std::unique_ptr<RaJpegEncoder> _encoder;
+
+    /**
+     * number of the next frame captured
+     */
+    uint64_t _next;
+
+    /**
+     * counters kept on the render thread
+     */
+    RaCaptureStats _stats;
+    std::chrono::steady_clock::time_point _last;
+    bool _hasLast;
+
+    /**
+     * AVI writer state, JPEGs that came out of the encoder by frame
+     * number, which may be out of order, and the number of the next frame
+     * to write.
+     */
+    RaAviWriter _avi;
+    std::mutex _mutex;
+    std::condition_variable _ready;
+    std::condition_variable _room;
+    std::map<uint64_t, Encoded> _encoded;
+    uint64_t _written;
+    uint64_t _writtenFrames;
+    uint64_t _writtenBytes;
+    uint64_t _writeDropped;
+    bool _stop;
+    std::thread _writer;
+};
+
+#endif /* SRC_RA_CAPTURE_HPP_ */
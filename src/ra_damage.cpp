@@ -0,0 +1,105 @@
+/*
+ * ra_damage.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_damage.hpp"
+#include <algorithm>
+#include <cstdint>
+
+static RaRect rect_union(const RaRect &a, const RaRect &b) {
+    int x0 = std::min(a.x, b.x);
+    int y0 = std::min(a.y, b.y);
+    int x1 = std::max(a.x + a.w, b.x + b.w);
+    int y1 = std::max(a.y + a.h, b.y + b.h);
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+static int rect_intersect_area(const RaRect &a, const RaRect &b) {
+    int w = std::min(a.x + a.w, b.x + b.w) - std::max(a.x, b.x);
+    int h = std::min(a.y + a.h, b.y + b.h) - std::max(a.y, b.y);
+    return (w > 0 && h > 0) ? w * h : 0;
+}
+
+/**
+ * two rects are worth merging if the union does not upload many more
+ * pixels than the two separate rects would.
+ */
+static bool should_merge(const RaRect &a, const RaRect &b) {
+    RaRect u = rect_union(a, b);
+    long separate = (long)a.area() + b.area() - rect_intersect_area(a, b);
+    // allow some slack, a few extra pixels are cheaper than another upload call
+    return (long)u.area() <= separate + separate / 4 + 64 * 64;
+}
+
+void RaDamage::setBounds(int width, int height)
+{
+    _width = width;
+    _height = height;
+    _rects.clear();
+}
+
+void RaDamage::add(int x, int y, int w, int h)
+{
+    // clip to bounds, the far edges in 64 bits, x + w can overflow an int
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = (int)std::min<int64_t>((int64_t)x + w, _width);
+    int y1 = (int)std::min<int64_t>((int64_t)y + h, _height);
+
+    RaRect r = {x0, y0, x1 - x0, y1 - y0};
+
+    if(r.empty()) {
+        return;
+    }
+
+    // keep merging until the new rect does not overlap anything else, a
+    // merge can grow the rect so that it overlaps rects it did not before.
+    bool merged = true;
+    while(merged) {
+        merged = false;
+        for(auto i = _rects.begin(); i != _rects.end(); ++i) {
+            if(should_merge(*i, r)) {
+                r = rect_union(*i, r);
+                _rects.erase(i);
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    _rects.push_back(r);
+
+    if(_rects.size() > MaxRects) {
+        RaRect bounds = _rects[0];
+        for(const RaRect &i : _rects) {
+            bounds = rect_union(bounds, i);
+        }
+        _rects.clear();
+        _rects.push_back(bounds);
+    }
+}
+
+void RaDamage::addAll()
+{
+    _rects.clear();
+    if(_width > 0 && _height > 0) {
+        _rects.push_back({0, 0, _width, _height});
+    }
+}
+
+bool RaDamage::full() const
+{
+    return _rects.size() == 1 && _rects[0].w == _width && _rects[0].h == _height;
+}
+
+long RaDamage::pixels() const
+{
+    long result = 0;
+    for(const RaRect &r : _rects) {
+        result += r.area();
+    }
+    return result;
+}
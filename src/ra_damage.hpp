@@ -0,0 +1,84 @@
+/*
+ * ra_damage.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_DAMAGE_HPP_
+#define SRC_RA_DAMAGE_HPP_
+
+#include <vector>
+
+/**
+ * integer rectangle in surface pixel coordinates, origin at top left,
+ * same as cairo image surfaces.
+ */
+struct RaRect {
+    int x;
+    int y;
+    int w;
+    int h;
+
+    int area() const { return w * h; }
+
+    bool empty() const { return w <= 0 || h <= 0; }
+};
+
+/**
+ * Tracks the damaged regions of a surface between flushes.
+ *
+ * Rectangles are clipped to the surface bounds, and overlapping or nearly
+ * overlapping rectangles are merged as they are added, so the list stays
+ * short. If too many disjoint rectangles accumulate, they collapse into
+ * their bounding box.
+ */
+class RaDamage {
+public:
+
+    /**
+     * max number of disjoint rects before collapsing to the bounding box,
+     * each rect costs one upload call.
+     */
+    enum { MaxRects = 16 };
+
+    RaDamage(): _width{0}, _height{0} {}
+
+    /**
+     * sets the surface size, rects are clipped to this.
+     */
+    void setBounds(int width, int height);
+
+    /**
+     * adds a damaged rectangle, merging with any existing rectangles.
+     */
+    void add(int x, int y, int w, int h);
+
+    /**
+     * marks the entire surface as damaged.
+     */
+    void addAll();
+
+    void clear() { _rects.clear(); }
+
+    bool empty() const { return _rects.empty(); }
+
+    /**
+     * is the whole surface damaged
+     */
+    bool full() const;
+
+    /**
+     * total number of damaged pixels
+     */
+    long pixels() const;
+
+    const std::vector<RaRect> &rects() const { return _rects; }
+
+private:
+    std::vector<RaRect> _rects;
+    int _width;
+    int _height;
+};
+
+#endif /* SRC_RA_DAMAGE_HPP_ */
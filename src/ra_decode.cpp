@@ -0,0 +1,175 @@
+/*
+ * ra_decode.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_decode.hpp"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/ImageData.h>
+#include <MagnumPlugins/TgaImporter/TgaImporter.h>
+
+#include <csetjmp>
+#include <cstdio>
+
+// jpeglib.h needs FILE and size_t first
+#include <jpeglib.h>
+
+using namespace Magnum;
+
+/**
+ * libjpeg reports errors by calling error_exit, which must not return,
+ * jump back to the decode call instead of exiting.
+ */
+struct RaDecodeJpegError {
+    jpeg_error_mgr mgr;
+    jmp_buf jump;
+};
+
+static void decode_jpeg_error_exit(j_common_ptr cinfo)
+{
+    RaDecodeJpegError *err = (RaDecodeJpegError*)cinfo->err;
+    longjmp(err->jump, 1);
+}
+
+static void decode_jpeg_output_message(j_common_ptr)
+{
+}
+
+/**
+ * decodes a JPEG into pixels, with row as scratch space.
+ *
+ * Nothing that needs destroying may live in here, libjpeg errors jump
+ * back to the setjmp.
+ */
+static bool decode_jpeg(const char *data, size_t size, std::vector<uint8_t> &pixels,
+        int &width, int &height, std::vector<uint8_t> &row)
+{
+    jpeg_decompress_struct cinfo;
+    RaDecodeJpegError err;
+
+    cinfo.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = decode_jpeg_error_exit;
+    err.mgr.output_message = decode_jpeg_output_message;
+
+    if(setjmp(err.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, (unsigned char*)data, (unsigned long)size);
+    jpeg_read_header(&cinfo, TRUE);
+
+#ifdef JCS_EXTENSIONS
+    cinfo.out_color_space = JCS_EXT_RGBA;
+#else
+    cinfo.out_color_space = JCS_RGB;
+#endif
+
+    jpeg_start_decompress(&cinfo);
+
+    width = cinfo.output_width;
+    height = cinfo.output_height;
+    pixels.resize((size_t)width * height * 4);
+    row.resize((size_t)width * 3);
+
+    while(cinfo.output_scanline < cinfo.output_height) {
+        uint8_t *dst = pixels.data() + (size_t)cinfo.output_scanline * width * 4;
+
+#ifdef JCS_EXTENSIONS
+        JSAMPROW rows = dst;
+        jpeg_read_scanlines(&cinfo, &rows, 1);
+#else
+        JSAMPROW rows = row.data();
+        jpeg_read_scanlines(&cinfo, &rows, 1);
+        for(int x = 0; x < width; ++x) {
+            dst[4 * x + 0] = row[3 * x + 0];
+            dst[4 * x + 1] = row[3 * x + 1];
+            dst[4 * x + 2] = row[3 * x + 2];
+            dst[4 * x + 3] = 255;
+        }
+#endif
+    }
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+/**
+ * decodes a TGA with the Magnum importer, which gives rows bottom up in
+ * RGB, RGBA or gray, into top down RGBA pixels.
+ */
+static bool decode_tga(const char *data, size_t size, std::vector<uint8_t> &pixels,
+        int &width, int &height)
+{
+    Trade::TgaImporter importer;
+
+    if(!importer.openData({data, size})) {
+        return false;
+    }
+
+    Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
+    if(!image) {
+        return false;
+    }
+
+    const PixelFormat format = image->format();
+    if(format != PixelFormat::RGBA8Unorm && format != PixelFormat::RGB8Unorm &&
+       format != PixelFormat::R8Unorm) {
+        return false;
+    }
+
+    const int pixelSize = image->pixelSize();
+    const int align = image->storage().alignment();
+    const size_t stride = ((size_t)image->size().x() * pixelSize + align - 1) / align * align;
+
+    width = image->size().x();
+    height = image->size().y();
+    pixels.resize((size_t)width * height * 4);
+
+    for(int y = 0; y < height; ++y) {
+        const uint8_t *src = (const uint8_t*)image->data().data() +
+                (size_t)(height - 1 - y) * stride;
+        uint8_t *dst = pixels.data() + (size_t)y * width * 4;
+
+        for(int x = 0; x < width; ++x, src += pixelSize, dst += 4) {
+            dst[0] = src[0];
+            dst[1] = pixelSize > 1 ? src[1] : src[0];
+            dst[2] = pixelSize > 1 ? src[2] : src[0];
+            dst[3] = pixelSize > 3 ? src[3] : 255;
+        }
+    }
+
+    return true;
+}
+
+bool RaDecode_Image(const char *data, std::size_t size, std::vector<uint8_t> &pixels,
+        int &width, int &height)
+{
+    width = height = 0;
+
+    const bool jpeg = size >= 2 && (uint8_t)data[0] == 0xff && (uint8_t)data[1] == 0xd8;
+
+    bool ok;
+    if(jpeg) {
+        std::vector<uint8_t> row;
+        ok = decode_jpeg(data, size, pixels, width, height, row);
+    }
+    else {
+        ok = decode_tga(data, size, pixels, width, height);
+    }
+
+    ok = ok && width > 0 && height > 0;
+
+    if(!ok) {
+        pixels.clear();
+        pixels.shrink_to_fit();
+    }
+    return ok;
+}
@@ -0,0 +1,27 @@
+/*
+ * ra_decode.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_DECODE_HPP_
+#define SRC_RA_DECODE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * decodes a TGA or JPEG image in memory into tightly packed RGBA8 pixels,
+ * rows top down. The format is told by the first bytes, anything that is
+ * not a JPEG is taken as a TGA.
+ *
+ * Safe to call on any thread, needs no GL context.
+ *
+ * @returns false if the data can not be decoded.
+ */
+bool RaDecode_Image(const char *data, std::size_t size, std::vector<uint8_t> &pixels,
+        int &width, int &height);
+
+#endif /* SRC_RA_DECODE_HPP_ */
@@ -0,0 +1,88 @@
+/*
+ * ra_fence.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_fence.hpp"
+#include <carbon.h>
+
+RaFence& RaFence::operator=(RaFence &&other) noexcept
+{
+    if(this != &other) {
+        reset();
+        _sync = other._sync;
+        other._sync = nullptr;
+    }
+    return *this;
+}
+
+void RaFence::insert()
+{
+    reset();
+    _sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool RaFence::signaled()
+{
+    if(!_sync) {
+        return true;
+    }
+
+    GLenum status = glClientWaitSync(_sync, 0, 0);
+
+    if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+        reset();
+        return true;
+    }
+
+    // GL_WAIT_FAILED means the sync object is gone, nothing to wait on
+    if(status == GL_WAIT_FAILED) {
+        reset();
+        return true;
+    }
+
+    return false;
+}
+
+bool RaFence::wait(uint64_t timeout)
+{
+    if(!_sync) {
+        return true;
+    }
+
+    // flush, otherwise the fence might never reach the GPU and we wait forever.
+    GLenum status = glClientWaitSync(_sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+
+    if(status == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+
+    reset();
+    return true;
+}
+
+void RaFence::reset()
+{
+    if(_sync) {
+        glDeleteSync(_sync);
+        _sync = nullptr;
+    }
+}
+
+CAPI_FUNC(int) RaFence_IsSignaled(RaFence *fence)
+{
+    return !fence || fence->signaled() ? 1 : 0;
+}
+
+CAPI_FUNC(int) RaFence_Wait(RaFence *fence, uint64_t timeout)
+{
+    return !fence || fence->wait(timeout) ? 1 : 0;
+}
+
+CAPI_FUNC(HRESULT) RaFence_Destroy(RaFence *fence)
+{
+    delete fence;
+    return S_OK;
+}
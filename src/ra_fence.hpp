@@ -0,0 +1,70 @@
+/*
+ * ra_fence.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_FENCE_HPP_
+#define SRC_RA_FENCE_HPP_
+
+#include <ra_fence.h>
+#include <Magnum/GL/OpenGL.h>
+#include <cstdint>
+
+/**
+ * Owns a GL sync object, signaled once the GPU has executed every command
+ * issued before insert().
+ *
+ * An empty fence (nothing inserted) counts as signaled. This is also the
+ * RaFence handle of the public API.
+ */
+struct RaFence {
+public:
+    RaFence(): _sync{nullptr} {}
+
+    ~RaFence() { reset(); }
+
+    RaFence(const RaFence&) = delete;
+    RaFence& operator=(const RaFence&) = delete;
+
+    RaFence(RaFence &&other) noexcept: _sync{other._sync} {
+        other._sync = nullptr;
+    }
+
+    RaFence& operator=(RaFence &&other) noexcept;
+
+    /**
+     * inserts a new fence into the command stream, replacing any
+     * existing one.
+     */
+    void insert();
+
+    /**
+     * has a fence been inserted that was not yet seen as signaled.
+     */
+    bool pending() const { return _sync != nullptr; }
+
+    /**
+     * checks the fence without blocking, releases the sync object
+     * once it is signaled.
+     */
+    bool signaled();
+
+    /**
+     * blocks until the fence is signaled, or timeout nanoseconds pass.
+     *
+     * @returns true if the fence was signaled.
+     */
+    bool wait(uint64_t timeout);
+
+    /**
+     * releases the sync object without waiting on it.
+     */
+    void reset();
+
+private:
+    GLsync _sync;
+};
+
+#endif /* SRC_RA_FENCE_HPP_ */
@@ -0,0 +1,120 @@
+/*
+ * ra_gl_registry.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_gl_registry.hpp"
+#include "CanvasBatchShader.h"
+#include "TexturedTriangleShader.h"
+#include "YuvShader.h"
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/Math/Vector2.h>
+
+#include <map>
+
+using namespace Magnum;
+using namespace Magnum::Examples;
+
+RaGlRegistry &RaGlRegistry::current()
+{
+    static std::map<const GL::Context*, RaGlRegistry*> registries;
+
+    // looked up on every draw, and there is usually just the one context
+    static const GL::Context *lastContext = NULL;
+    static RaGlRegistry *lastRegistry = NULL;
+
+    const GL::Context *context = &GL::Context::current();
+    if(context != lastContext) {
+        RaGlRegistry *&registry = registries[context];
+        if(!registry) {
+            registry = new RaGlRegistry();
+        }
+        lastContext = context;
+        lastRegistry = registry;
+    }
+    return *lastRegistry;
+}
+
+/**
+ * the object in slot if it is still alive, otherwise a new one.
+ */
+template<class T, class Create>
+static std::shared_ptr<T> acquire(std::weak_ptr<T> &slot, Create create)
+{
+    std::shared_ptr<T> result = slot.lock();
+    if(!result) {
+        result = create();
+        slot = result;
+    }
+    return result;
+}
+
+std::shared_ptr<TexturedTriangleShader> RaGlRegistry::texturedShader()
+{
+    return acquire(_texturedShader, [this] {
+        ++_compiled;
+        return std::make_shared<TexturedTriangleShader>();
+    });
+}
+
+std::shared_ptr<YuvShader> RaGlRegistry::yuvShader()
+{
+    return acquire(_yuvShader, [this] {
+        ++_compiled;
+        return std::make_shared<YuvShader>();
+    });
+}
+
+std::shared_ptr<CanvasBatchShader> RaGlRegistry::batchShader()
+{
+    return acquire(_batchShader, [this] {
+        ++_compiled;
+        return std::make_shared<CanvasBatchShader>();
+    });
+}
+
+std::shared_ptr<GL::Buffer> RaGlRegistry::quadBuffer()
+{
+    return acquire(_quadBuffer, [] {
+        struct TriangleVertex {
+            Vector2 position;
+            Vector2 textureCoordinates;
+        };
+        const TriangleVertex data[]{
+            {{-1.f, -1.f}, {0.0f, 1.0f}}, /* Left position and texture coordinate */
+            {{ 1.f, -1.f}, {1.0f, 1.0f}}, /* Right position and texture coordinate */
+            {{-1.f,  1.f}, {0.0f, 0.0f}},  /* Top position and texture coordinate */
+            {{ 1.f,  1.f}, {1.0f, 0.0f}}  /* Top position and texture coordinate */
+        };
+
+        std::shared_ptr<GL::Buffer> buffer = std::make_shared<GL::Buffer>();
+        buffer->setData(data);
+        return buffer;
+    });
+}
+
+std::shared_ptr<GL::Mesh> RaGlRegistry::quadMesh()
+{
+    return acquire(_quadMesh, [this] {
+        // the mesh only references the buffer, so keeps it with it
+        struct Quad {
+            std::shared_ptr<GL::Buffer> buffer;
+            GL::Mesh mesh;
+        };
+
+        std::shared_ptr<Quad> quad = std::make_shared<Quad>();
+        quad->buffer = quadBuffer();
+        quad->mesh.setCount(4)
+            .setPrimitive(GL::MeshPrimitive::TriangleStrip)
+            .addVertexBuffer(*quad->buffer, 0,
+                TexturedTriangleShader::Position{},
+                TexturedTriangleShader::TextureCoordinates{});
+
+        return std::shared_ptr<GL::Mesh>(quad, &quad->mesh);
+    });
+}
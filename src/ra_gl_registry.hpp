@@ -0,0 +1,93 @@
+/*
+ * ra_gl_registry.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_GL_REGISTRY_HPP_
+#define SRC_RA_GL_REGISTRY_HPP_
+
+#include "ra_gl_state.hpp"
+#include <Magnum/GL/GL.h>
+
+#include <memory>
+
+namespace Magnum { namespace Examples {
+class CanvasBatchShader;
+class TexturedTriangleShader;
+class YuvShader;
+}}
+
+/**
+ * Shader programs, meshes and GL state shared by everything drawn in a GL
+ * context.
+ *
+ * Each program is compiled the first time it is asked for, and the unit
+ * quad is built once, after that every canvas, batch, atlas and image of
+ * the context gets the same objects. The registry only keeps weak
+ * references, the objects are deleted when the last user lets go of
+ * them, and built again when next needed.
+ *
+ * Programs are shared, so users must set every uniform they rely on
+ * before drawing, rather than counting on what they set last time.
+ * Like the surface pool, it must only be used from the thread of the
+ * context.
+ */
+class RaGlRegistry {
+public:
+
+    /**
+     * the registry of the current GL context, created on first use. It
+     * is never destroyed.
+     */
+    static RaGlRegistry &current();
+
+    RaGlRegistry(const RaGlRegistry&) = delete;
+    RaGlRegistry& operator=(const RaGlRegistry&) = delete;
+
+    std::shared_ptr<Magnum::Examples::TexturedTriangleShader> texturedShader();
+
+    std::shared_ptr<Magnum::Examples::YuvShader> yuvShader();
+
+    std::shared_ptr<Magnum::Examples::CanvasBatchShader> batchShader();
+
+    /**
+     * the quad covering clip space, a 4 vertex triangle strip, with
+     * position and texture coordinates at attributes 0 and 1, as all the
+     * shaders take them.
+     */
+    std::shared_ptr<Magnum::GL::Mesh> quadMesh();
+
+    /**
+     * vertex buffer of the quad, for meshes that add their own per
+     * instance attributes. Meshes only reference the buffer, so hold on
+     * to it for as long as the mesh.
+     */
+    std::shared_ptr<Magnum::GL::Buffer> quadBuffer();
+
+    /**
+     * number of programs compiled in this context so far.
+     */
+    int compiled() const { return _compiled; }
+
+    /**
+     * the GL state the renderer last set in this context.
+     */
+    RaGlState &state() { return _state; }
+
+private:
+    RaGlRegistry(): _compiled{0} {}
+
+    std::weak_ptr<Magnum::Examples::TexturedTriangleShader> _texturedShader;
+    std::weak_ptr<Magnum::Examples::YuvShader> _yuvShader;
+    std::weak_ptr<Magnum::Examples::CanvasBatchShader> _batchShader;
+    std::weak_ptr<Magnum::GL::Mesh> _quadMesh;
+    std::weak_ptr<Magnum::GL::Buffer> _quadBuffer;
+
+    int _compiled;
+
+    RaGlState _state;
+};
+
+#endif /* SRC_RA_GL_REGISTRY_HPP_ */
@@ -0,0 +1,120 @@
+/*
+ * ra_gl_state.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_gl_state.hpp"
+
+using namespace Magnum;
+
+RaGlState::RaGlState(): _frame{}, _lastFrame{}
+{
+    invalidate();
+}
+
+void RaGlState::beginFrame()
+{
+    _lastFrame = _frame;
+    _frame = {};
+
+    invalidate();
+}
+
+void RaGlState::invalidate()
+{
+    _program = 0;
+    _mesh = 0;
+
+    for(GLuint &texture : _textures) {
+        texture = 0;
+    }
+
+    _blending = -1;
+    _blendFunctionKnown = false;
+}
+
+void RaGlState::bind(Int unit, GL::AbstractTexture &texture)
+{
+    // only counted, Magnum keeps its own record of the bound textures, and
+    // skips the bind if the texture is already bound to the unit
+    if(unit < TextureUnits && _textures[unit] == texture.id()) {
+        _frame.textures_elided += 1;
+    }
+    else {
+        if(unit < TextureUnits) {
+            _textures[unit] = texture.id();
+        }
+        _frame.textures += 1;
+    }
+
+    texture.bind(unit);
+}
+
+void RaGlState::bindTexture(Int unit, GL::Texture2D &texture)
+{
+    bind(unit, texture);
+}
+
+void RaGlState::bindTexture(Int unit, GL::Texture2DArray &texture)
+{
+    bind(unit, texture);
+}
+
+void RaGlState::setBlending(bool enabled)
+{
+    if(_blending == (int)enabled) {
+        _frame.blends_elided += 1;
+        return;
+    }
+
+    if(enabled) {
+        GL::Renderer::enable(GL::Renderer::Feature::Blending);
+    }
+    else {
+        GL::Renderer::disable(GL::Renderer::Feature::Blending);
+    }
+
+    _blending = enabled;
+    _frame.blends += 1;
+}
+
+void RaGlState::setBlendFunction(GL::Renderer::BlendFunction source,
+        GL::Renderer::BlendFunction destination)
+{
+    if(_blendFunctionKnown && _blendSource == source && _blendDestination == destination) {
+        _frame.blends_elided += 1;
+        return;
+    }
+
+    GL::Renderer::setBlendFunction(source, destination);
+
+    _blendFunctionKnown = true;
+    _blendSource = source;
+    _blendDestination = destination;
+    _frame.blends += 1;
+}
+
+void RaGlState::draw(GL::AbstractShaderProgram &program, GL::Mesh &mesh)
+{
+    if(_program == program.id()) {
+        _frame.programs_elided += 1;
+    }
+    else {
+        _program = program.id();
+        _frame.programs += 1;
+    }
+
+    // without vertex array objects, the attributes are set up on each draw
+    if(mesh.id() && _mesh == mesh.id()) {
+        _frame.meshes_elided += 1;
+    }
+    else {
+        _mesh = mesh.id();
+        _frame.meshes += 1;
+    }
+
+    program.draw(mesh);
+    _frame.draws += 1;
+}
@@ -0,0 +1,92 @@
+/*
+ * ra_gl_state.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_GL_STATE_HPP_
+#define SRC_RA_GL_STATE_HPP_
+
+#include <ra_renderer.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureArray.h>
+
+/**
+ * The GL state the renderer last set in a context, so the draw path only
+ * changes what is different from the previous draw.
+ *
+ * Everything drawn by radium binds textures, sets blending and draws
+ * through here, and counts what it asked for in RaRenderStats. Only
+ * blending is filtered here, Magnum does not track it. Programs, textures
+ * and vertex arrays are always handed to Magnum, which keeps its own
+ * record of what is bound and skips the calls that change nothing, they
+ * are only counted here.
+ *
+ * A recorded id can go stale if its object is deleted and the id reused,
+ * and user code may change the blending behind our back, so the state is
+ * invalidated at the start of each frame, and after user callbacks.
+ */
+class RaGlState {
+public:
+
+    /**
+     * texture units counted, the shaders use the first 3.
+     */
+    enum { TextureUnits = 4 };
+
+    RaGlState();
+
+    /**
+     * keeps the counters of the frame that ended, and invalidates.
+     */
+    void beginFrame();
+
+    /**
+     * forgets everything set, the next change of each state is made.
+     */
+    void invalidate();
+
+    void bindTexture(Magnum::Int unit, Magnum::GL::Texture2D &texture);
+
+    void bindTexture(Magnum::Int unit, Magnum::GL::Texture2DArray &texture);
+
+    void setBlending(bool enabled);
+
+    void setBlendFunction(Magnum::GL::Renderer::BlendFunction source,
+            Magnum::GL::Renderer::BlendFunction destination);
+
+    /**
+     * draws the mesh with the program, uniforms and textures must be set.
+     */
+    void draw(Magnum::GL::AbstractShaderProgram &program, Magnum::GL::Mesh &mesh);
+
+    /**
+     * counters of the last complete frame
+     */
+    const RaRenderStats &frameStats() const { return _lastFrame; }
+
+private:
+    void bind(Magnum::Int unit, Magnum::GL::AbstractTexture &texture);
+
+    GLuint _program;
+    GLuint _mesh;
+    GLuint _textures[TextureUnits];
+
+    /**
+     * 0 or 1, -1 if unknown
+     */
+    int _blending;
+
+    bool _blendFunctionKnown;
+    Magnum::GL::Renderer::BlendFunction _blendSource;
+    Magnum::GL::Renderer::BlendFunction _blendDestination;
+
+    RaRenderStats _frame;
+    RaRenderStats _lastFrame;
+};
+
+#endif /* SRC_RA_GL_STATE_HPP_ */
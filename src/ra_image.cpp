@@ -0,0 +1,329 @@
+/*
+ * ra_image.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_image.hpp"
+#include "ra_asset.hpp"
+#include "ra_gl_registry.hpp"
+#include "ra_pixel_convert.hpp"
+
+#include <Magnum/ImageView.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <carbon.h>
+
+using namespace Magnum;
+using namespace Magnum::Examples;
+
+RaImage::RaImage(): _hasImage{false}, _asset{NULL}, _isYuv{false}, _yuvFormat{0},
+    _yuvColorSpace{RA_YUV_BT601}, _uploadStats{}
+{
+    RaGlRegistry &registry = RaGlRegistry::current();
+    _mesh = registry.quadMesh();
+    _shader = registry.texturedShader();
+}
+
+RaImage::~RaImage()
+{
+    clearAsset();
+}
+
+HRESULT RaImage::setAsset(RaAsset *asset)
+{
+    if(asset) {
+        asset->retain();
+    }
+
+    clearAsset();
+
+    _asset = asset;
+    _hasImage = false;
+    return S_OK;
+}
+
+void RaImage::clearAsset()
+{
+    if(_asset) {
+        _asset->release();
+        _asset = NULL;
+    }
+}
+
+void RaImage::draw()
+{
+    RaGlState &state = RaGlRegistry::current().state();
+
+    // the programs are shared, canvases leave their own uniforms set
+    if(_asset) {
+        if(_asset->state == RA_ASSET_READY) {
+            state.setBlending(false);
+            _shader->setTextureScale({1.0f, 1.0f})
+                .setAlphaBlending(false)
+                .bindTexture(state, _asset->texture);
+            state.draw(*_shader, *_mesh);
+        }
+    }
+    else if(_hasImage && _isYuv) {
+        state.setBlending(false);
+        _yuvShader->setColorSpace(_yuvColorSpace);
+        if(_yuvFormat == RA_PIXEL_NV12) {
+            _yuvShader->bindTextures(state, _yuvPlanes[0], _yuvPlanes[1]);
+        }
+        else {
+            _yuvShader->bindTextures(state, _yuvPlanes[0], _yuvPlanes[1], _yuvPlanes[2]);
+        }
+        state.draw(*_yuvShader, *_mesh);
+    }
+    else if(_hasImage) {
+        state.setBlending(false);
+        _shader->setTextureScale({1.0f, 1.0f})
+            .setAlphaBlending(false)
+            .bindTexture(state, _texture);
+        state.draw(*_shader, *_mesh);
+    }
+}
+
+void RaImage::resizeImage(const Vector2i& size)
+{
+    if(size == _imageSize) {
+        return;
+    }
+
+    _texture = GL::Texture2D{};
+    _texture.setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setMagnificationFilter(GL::SamplerFilter::Linear)
+        .setMinificationFilter(GL::SamplerFilter::Linear)
+        .setStorage(1, GL::TextureFormat::RGBA8, size);
+
+    _imageSize = size;
+}
+
+HRESULT RaImage::setImage(uint32_t width,
+        uint32_t height, uint32_t format, const void *data)
+{
+    if(format == RA_PIXEL_NV12 || format == RA_PIXEL_I420) {
+        return setImageYuv(width, height, format, data);
+    }
+
+    int pixelSize = RaPixelFormat_Size(format);
+
+    if(!pixelSize) {
+        return c_error(E_INVALIDARG, "unknown pixel format");
+    }
+
+    if(!data || width == 0 || height == 0) {
+        return c_error(E_INVALIDARG, "empty image");
+    }
+
+    resizeImage({(int)width, (int)height});
+
+    // the region below is the whole image, so it replaces whatever was
+    // shown before
+    clearAsset();
+    _hasImage = true;
+    _isYuv = false;
+
+    return setImageRegion(0, 0, width, height, width * pixelSize, format, data);
+}
+
+HRESULT RaImage::setImageRegion(uint32_t x, uint32_t y,
+        uint32_t width, uint32_t height, uint32_t stride, uint32_t format,
+        const void *data)
+{
+    int pixelSize = RaPixelFormat_Size(format);
+
+    if(!pixelSize) {
+        return c_error(E_INVALIDARG, "unknown or planar pixel format");
+    }
+
+    if(!data || width == 0 || height == 0) {
+        return c_error(E_INVALIDARG, "empty image");
+    }
+
+    // the rest of the RGB texture would be stale, or never set
+    if(_asset || !_hasImage || _isYuv) {
+        return c_error(E_FAIL, "the current image is not an RGB image set with "
+                "RaApplication_SetImage");
+    }
+
+    // written so nothing wraps around, and checked first, so the row size
+    // below is bounded by the image
+    const uint32_t imageWidth = _imageSize.x(), imageHeight = _imageSize.y();
+    if(x > imageWidth || width > imageWidth - x ||
+       y > imageHeight || height > imageHeight - y) {
+        return c_error(E_INVALIDARG, "region is outside of the image");
+    }
+
+    if(stride == 0) {
+        stride = width * pixelSize;
+    }
+
+    if(stride < width * pixelSize) {
+        return c_error(E_INVALIDARG, "stride is smaller than a row of the image");
+    }
+
+    RaPixelSource src;
+    src.origin_x = x;
+    src.origin_y = y;
+
+    if(RaUpload_NativeFormat(format, src.format, src.type)) {
+        if(stride % pixelSize != 0) {
+            return c_error(E_INVALIDARG, "stride must be a multiple of the pixel size");
+        }
+
+        // GL reads only up to the last pixel of the last row, but the
+        // image view is checked against whole rows.
+        src.data = data;
+        src.size = (std::size_t)stride * height;
+        src.row_length = stride / pixelSize;
+        src.pixel_size = pixelSize;
+    }
+    else {
+        RaPixelConverter convert = RaPixelConvert_ToBGRA8(format);
+
+        const std::size_t rowSize = (std::size_t)width * 4;
+
+        _convertBuffer.resize(rowSize * height);
+
+        const char *row = static_cast<const char*>(data);
+
+        for(uint32_t i = 0; i < height; ++i) {
+            convert(row, _convertBuffer.data() + i * rowSize, width);
+            row += stride;
+        }
+
+        src.data = _convertBuffer.data();
+        src.size = rowSize * height;
+        src.row_length = width;
+        src.pixel_size = 4;
+        src.format = GL::PixelFormat::BGRA;
+        src.type = GL::PixelType::UnsignedByte;
+    }
+
+    RaRect rect = {(int)x, (int)y, (int)width, (int)height};
+
+    if(_upload) {
+        return _upload->upload(_texture, src, &rect, 1, _uploadStats);
+    }
+
+    RaUpload_Direct(_texture, src, &rect, 1, _uploadStats);
+
+    return S_OK;
+}
+
+void RaImage::resizeYuv(const Vector2i& size, uint32_t format)
+{
+    if(size == _yuvSize && format == _yuvFormat) {
+        return;
+    }
+
+    const Vector2i chroma = (size + Vector2i{1})/2;
+
+    const GL::TextureFormat chromaFormat = format == RA_PIXEL_NV12 ?
+        GL::TextureFormat::RG8 : GL::TextureFormat::R8;
+
+    const Vector2i sizes[] = {size, chroma, chroma};
+    const GL::TextureFormat formats[] = {GL::TextureFormat::R8, chromaFormat, chromaFormat};
+    const int planes = format == RA_PIXEL_NV12 ? 2 : 3;
+
+    for(int i = 0; i < planes; ++i) {
+        _yuvPlanes[i] = GL::Texture2D{};
+        _yuvPlanes[i].setWrapping(GL::SamplerWrapping::ClampToEdge)
+            .setMagnificationFilter(GL::SamplerFilter::Linear)
+            .setMinificationFilter(GL::SamplerFilter::Linear)
+            .setStorage(1, formats[i], sizes[i]);
+    }
+
+    _yuvSize = size;
+    _yuvFormat = format;
+}
+
+void RaImage::uploadPlane(GL::Texture2D& texture, const void* data,
+        const Vector2i& size, GL::PixelFormat format, int pixelSize)
+{
+    RaPixelSource src;
+    src.data = data;
+    src.size = (std::size_t)size.x() * size.y() * pixelSize;
+    src.row_length = size.x();
+    src.pixel_size = pixelSize;
+    src.format = format;
+    src.type = GL::PixelType::UnsignedByte;
+
+    RaRect all = {0, 0, size.x(), size.y()};
+
+    if(_upload) {
+        _upload->upload(texture, src, &all, 1, _uploadStats);
+    }
+    else {
+        RaUpload_Direct(texture, src, &all, 1, _uploadStats);
+    }
+}
+
+HRESULT RaImage::setImageYuv(uint32_t width, uint32_t height,
+        uint32_t format, const void* data)
+{
+    if(!data || width == 0 || height == 0) {
+        return c_error(E_INVALIDARG, "empty image");
+    }
+
+    if(!_yuvShader) {
+        _yuvShader = RaGlRegistry::current().yuvShader();
+    }
+
+    const Vector2i size{(int)width, (int)height};
+    const Vector2i chroma = (size + Vector2i{1})/2;
+
+    resizeYuv(size, format);
+
+    const char* y = static_cast<const char*>(data);
+    const char* c = y + (std::size_t)size.x() * size.y();
+
+    uploadPlane(_yuvPlanes[0], y, size, GL::PixelFormat::Red, 1);
+
+    if(format == RA_PIXEL_NV12) {
+        uploadPlane(_yuvPlanes[1], c, chroma, GL::PixelFormat::RG, 2);
+    }
+    else {
+        uploadPlane(_yuvPlanes[1], c, chroma, GL::PixelFormat::Red, 1);
+        uploadPlane(_yuvPlanes[2], c + (std::size_t)chroma.x() * chroma.y(),
+            chroma, GL::PixelFormat::Red, 1);
+    }
+
+    clearAsset();
+    _hasImage = true;
+    _isYuv = true;
+
+    return S_OK;
+}
+
+HRESULT RaImage::setYuvColorSpace(uint32_t colorSpace)
+{
+    if(colorSpace > RA_YUV_BT709_FULL) {
+        return c_error(E_INVALIDARG, "unknown YUV color space");
+    }
+
+    // set on the shader when drawing
+    _yuvColorSpace = colorSpace;
+
+    return S_OK;
+}
+
+HRESULT RaImage::setUploadBuffers(int count)
+{
+    if(count < 0) {
+        return c_error(E_INVALIDARG, "upload buffer count must be >= 0");
+    }
+
+    if(count == 0) {
+        _upload.reset();
+    }
+    else if(!_upload || _upload->slots() != count) {
+        _upload.reset(new RaUploadRing(count));
+    }
+
+    return S_OK;
+}
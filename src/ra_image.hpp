@@ -0,0 +1,131 @@
+/*
+ * ra_image.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_IMAGE_HPP_
+#define SRC_RA_IMAGE_HPP_
+
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "TexturedTriangleShader.h"
+#include "YuvShader.h"
+#include "ra_upload.hpp"
+
+#include <memory>
+#include <vector>
+
+struct RaAsset;
+
+/**
+ * The image an application draws under its window's canvases, set with
+ * RaApplication_SetImage.
+ *
+ * Shared by the windowed and headless applications, so both upload and
+ * draw the image the same way. Needs a current GL context.
+ */
+class RaImage {
+public:
+
+    RaImage();
+
+    /**
+     * releases the asset drawn, if any.
+     */
+    ~RaImage();
+
+    RaImage(const RaImage&) = delete;
+    RaImage& operator=(const RaImage&) = delete;
+
+    HRESULT setImage(uint32_t width, uint32_t height, uint32_t format, const void* data);
+
+    /**
+     * updates part of the current image, rows of the source are stride
+     * bytes apart. Fails unless the current image is an RGB one.
+     */
+    HRESULT setImageRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+            uint32_t stride, uint32_t format, const void* data);
+
+    /**
+     * one of RaYUVColorSpace, used for NV12 and I420 images.
+     */
+    HRESULT setYuvColorSpace(uint32_t colorSpace);
+
+    /**
+     * number of pixel-unpack buffers used by setImage, 0 for synchronous
+     * uploads.
+     */
+    HRESULT setUploadBuffers(int count);
+
+    /**
+     * draws the texture of an asset once it is ready, instead of an image
+     * set with setImage, keeps a reference to the asset until another
+     * image is set. NULL draws nothing.
+     */
+    HRESULT setAsset(RaAsset *asset);
+
+    const RaUploadStats& uploadStats() const { return _uploadStats; }
+
+    /**
+     * draws the image over the whole bound framebuffer, if one is set.
+     */
+    void draw();
+
+private:
+    /**
+     * makes sure the image texture has the given size, textures have
+     * immutable storage, so a new one is created if it changes.
+     */
+    void resizeImage(const Magnum::Vector2i& size);
+
+    /**
+     * uploads NV12 or I420 images, each plane to its own texture, the
+     * shader converts to RGB.
+     */
+    HRESULT setImageYuv(uint32_t width, uint32_t height, uint32_t format, const void* data);
+
+    void resizeYuv(const Magnum::Vector2i& size, uint32_t format);
+
+    void uploadPlane(Magnum::GL::Texture2D& texture, const void* data,
+            const Magnum::Vector2i& size, Magnum::GL::PixelFormat format, int pixelSize);
+
+    void clearAsset();
+
+    /**
+     * the quad and program of the context, shared with the canvases.
+     */
+    std::shared_ptr<Magnum::GL::Mesh> _mesh;
+    std::shared_ptr<Magnum::Examples::TexturedTriangleShader> _shader;
+    Magnum::GL::Texture2D _texture;
+    Magnum::Vector2i _imageSize;
+    bool _hasImage;
+
+    RaAsset *_asset;
+
+    /**
+     * planes of the current YUV image, Y, then U or UV, then V for I420.
+     * The YUV shader is only looked up, and compiled if no one else has,
+     * once a YUV image is set.
+     */
+    bool _isYuv;
+    Magnum::GL::Texture2D _yuvPlanes[3];
+    Magnum::Vector2i _yuvSize;
+    uint32_t _yuvFormat;
+    uint32_t _yuvColorSpace;
+    std::shared_ptr<Magnum::Examples::YuvShader> _yuvShader;
+
+    /**
+     * scratch space for formats that are converted before uploading,
+     * kept between frames to avoid allocating for each image.
+     */
+    std::vector<char> _convertBuffer;
+
+    std::unique_ptr<RaUploadRing> _upload;
+    RaUploadStats _uploadStats;
+};
+
+#endif /* SRC_RA_IMAGE_HPP_ */
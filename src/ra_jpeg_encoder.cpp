@@ -0,0 +1,563 @@
+/*
+ * ra_jpeg_encoder.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_jpeg_encoder.hpp"
+#include "ra_canvas.hpp"
+#include "ra_pixel_convert.hpp"
+#include "ra_window.hpp"
+#include <carbon.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+
+// jpeglib.h needs FILE and size_t first
+#include <jpeglib.h>
+
+/**
+ * libjpeg reports errors by calling error_exit, which must not return,
+ * jump back to the encode call instead of exiting.
+ */
+struct RaJpegError {
+    jpeg_error_mgr mgr;
+    jmp_buf jump;
+};
+
+static void jpeg_error_exit(j_common_ptr cinfo)
+{
+    RaJpegError *err = (RaJpegError*)cinfo->err;
+    longjmp(err->jump, 1);
+}
+
+static void jpeg_output_message(j_common_ptr)
+{
+}
+
+/**
+ * libjpeg destination that writes to a buffer of the worker, which
+ * grows to the largest frame and is reused.
+ */
+struct RaJpegDest {
+    jpeg_destination_mgr mgr;
+    std::vector<JOCTET> *buffer;
+    std::size_t size;
+};
+
+static void dest_init(j_compress_ptr cinfo)
+{
+    RaJpegDest *dest = (RaJpegDest*)cinfo->dest;
+    if(dest->buffer->size() < 65536) {
+        dest->buffer->resize(65536);
+    }
+    dest->mgr.next_output_byte = dest->buffer->data();
+    dest->mgr.free_in_buffer = dest->buffer->size();
+    dest->size = 0;
+}
+
+static boolean dest_empty(j_compress_ptr cinfo)
+{
+    // called when the whole buffer is full
+    RaJpegDest *dest = (RaJpegDest*)cinfo->dest;
+    std::size_t used = dest->buffer->size();
+    dest->buffer->resize(used * 2);
+    dest->mgr.next_output_byte = dest->buffer->data() + used;
+    dest->mgr.free_in_buffer = dest->buffer->size() - used;
+    return TRUE;
+}
+
+static void dest_term(j_compress_ptr cinfo)
+{
+    RaJpegDest *dest = (RaJpegDest*)cinfo->dest;
+    dest->size = dest->buffer->size() - dest->mgr.free_in_buffer;
+}
+
+/**
+ * libjpeg state and scratch memory of a worker, kept for all the frames
+ * it encodes.
+ */
+struct RaJpegWorker {
+    jpeg_compress_struct cinfo;
+    RaJpegError err;
+    RaJpegDest dest;
+    std::vector<JOCTET> buffer;
+    std::vector<uint8_t> row;
+    RaPixelConverter unpremultiply;
+
+    RaJpegWorker() {
+        cinfo.err = jpeg_std_error(&err.mgr);
+        err.mgr.error_exit = jpeg_error_exit;
+        err.mgr.output_message = jpeg_output_message;
+        jpeg_create_compress(&cinfo);
+
+        dest.mgr.init_destination = dest_init;
+        dest.mgr.empty_output_buffer = dest_empty;
+        dest.mgr.term_destination = dest_term;
+        dest.buffer = &buffer;
+        dest.size = 0;
+        cinfo.dest = &dest.mgr;
+
+        unpremultiply = RaPixelConvert_Unpremultiply();
+    }
+
+    ~RaJpegWorker() {
+        jpeg_destroy_compress(&cinfo);
+    }
+};
+
+/**
+ * compresses a frame into the worker's buffer, premultiplied pixels are
+ * un-premultiplied in place, the frame is not used again.
+ *
+ * Nothing that needs destroying may live in here, libjpeg errors jump
+ * back to the setjmp.
+ */
+static bool compress(RaJpegWorker &w, RaJpegEncoder::Frame &frame, int quality)
+{
+    jpeg_compress_struct *cinfo = &w.cinfo;
+
+    if(setjmp(w.err.jump)) {
+        jpeg_abort_compress(cinfo);
+        return false;
+    }
+
+    cinfo->image_width = frame.width;
+    cinfo->image_height = frame.height;
+
+#ifdef JCS_EXTENSIONS
+    // libjpeg-turbo reads 4 byte pixels itself
+    cinfo->input_components = 4;
+    cinfo->in_color_space = frame.format == RA_PIXEL_RGBA8 ? JCS_EXT_RGBA : JCS_EXT_BGRA;
+    RaPixelConverter toRgb = NULL;
+#else
+    cinfo->input_components = 3;
+    cinfo->in_color_space = JCS_RGB;
+    RaPixelConverter toRgb = RaPixelConvert_ToRGB8(frame.format);
+#endif
+
+    jpeg_set_defaults(cinfo);
+    jpeg_set_quality(cinfo, quality, TRUE);
+    jpeg_start_compress(cinfo, TRUE);
+
+    const std::size_t pitch = (std::size_t)frame.width * 4;
+
+    while(cinfo->next_scanline < cinfo->image_height) {
+        uint8_t *src = frame.pixels.data() + cinfo->next_scanline * pitch;
+
+        if(frame.flags & RA_JPEG_UNPREMULTIPLY) {
+            w.unpremultiply(src, src, frame.width);
+        }
+
+        JSAMPROW row = src;
+        if(toRgb) {
+            toRgb(src, w.row.data(), frame.width);
+            row = w.row.data();
+        }
+
+        jpeg_write_scanlines(cinfo, &row, 1);
+    }
+
+    jpeg_finish_compress(cinfo);
+    return true;
+}
+
+RaJpegEncoder::RaJpegEncoder(int threads, int capacity, int quality):
+    _quality{std::min(100, std::max(1, quality))}, _out{0}, _stop{false}, _stats{}
+{
+    if(threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    _capacity = capacity > 0 ? capacity : 2 * threads;
+
+    for(int i = 0; i < threads; ++i) {
+        _workers.emplace_back(&RaJpegEncoder::run, this);
+    }
+}
+
+RaJpegEncoder::~RaJpegEncoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _work.notify_all();
+
+    for(std::thread &t : _workers) {
+        t.join();
+    }
+}
+
+std::unique_ptr<RaJpegEncoder::Frame> RaJpegEncoder::acquire(int width, int height, bool wait)
+{
+    std::unique_ptr<Frame> frame;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if(_out >= _capacity) {
+            if(!wait) {
+                return nullptr;
+            }
+            _stats.waits += 1;
+            _room.wait(lock, [this] { return _out < _capacity; });
+        }
+
+        _out += 1;
+
+        if(!_free.empty()) {
+            frame = std::move(_free.back());
+            _free.pop_back();
+        }
+    }
+
+    if(!frame) {
+        frame.reset(new Frame());
+        frame->owner = this;
+    }
+
+    frame->pixels.resize((std::size_t)width * height * 4);
+    frame->width = width;
+    frame->height = height;
+    frame->format = RA_PIXEL_BGRA8;
+    frame->flags = 0;
+    frame->path.clear();
+    frame->callback = NULL;
+    frame->userData = NULL;
+    frame->window = NULL;
+
+    return frame;
+}
+
+void RaJpegEncoder::submit(std::unique_ptr<Frame> frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(std::move(frame));
+    }
+    _work.notify_one();
+}
+
+void RaJpegEncoder::release(std::unique_ptr<Frame> frame)
+{
+    recycle(std::move(frame));
+}
+
+void RaJpegEncoder::recycle(std::unique_ptr<Frame> frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free.push_back(std::move(frame));
+        _out -= 1;
+    }
+    _room.notify_all();
+}
+
+void RaJpegEncoder::finish()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _room.wait(lock, [this] { return _out == 0; });
+}
+
+HRESULT RaJpegEncoder::readWindow(RaWindow *window, std::unique_ptr<Frame> frame)
+{
+    frame->window = window;
+
+    // the frame belongs to the read until it is delivered
+    Frame *pending = frame.get();
+    HRESULT result = RaWindow_ReadPixelsAsync(window, 0, 0, pending->width, pending->height,
+            RA_PIXEL_BGRA8, pending->pixels.data(), frameRead, pending);
+
+    if(FAILED(result)) {
+        release(std::move(frame));
+        return result;
+    }
+
+    _windows[window] += 1;
+    frame.release();
+    return S_OK;
+}
+
+void RaJpegEncoder::makeRoom(RaWindow *window)
+{
+    if(stats().queued >= _capacity) {
+        RaWindow_PollReadPixels(window, 1);
+    }
+}
+
+void RaJpegEncoder::finishReads()
+{
+    // delivering reads drops their windows
+    std::vector<RaWindow*> windows;
+    for(const auto &entry : _windows) {
+        windows.push_back(entry.first);
+    }
+
+    for(RaWindow *window : windows) {
+        RaWindow_PollReadPixels(window, 1);
+
+        if(!_windows.count(window)) {
+            continue;
+        }
+
+        // a read still waiting for a frame the window could not draw is
+        // never delivered, give its frame back rather than wait for it
+        std::vector<RaWindow::DeferredRead> dropped = window->cancelReads(
+                [this](const RaWindow::DeferredRead &read) {
+            return read.callback == frameRead && ((Frame*)read.user_data)->owner == this;
+        });
+
+        for(const RaWindow::DeferredRead &read : dropped) {
+            readDone(window);
+            release(std::unique_ptr<Frame>((Frame*)read.user_data));
+        }
+    }
+}
+
+void RaJpegEncoder::frameRead(void *userData)
+{
+    std::unique_ptr<Frame> frame((Frame*)userData);
+    RaJpegEncoder *encoder = frame->owner;
+    encoder->readDone(frame->window);
+    encoder->submit(std::move(frame));
+}
+
+void RaJpegEncoder::readDone(RaWindow *window)
+{
+    auto it = _windows.find(window);
+    if(it != _windows.end() && --it->second == 0) {
+        _windows.erase(it);
+    }
+}
+
+RaJpegStats RaJpegEncoder::stats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    RaJpegStats result = _stats;
+    result.queued = _out;
+    return result;
+}
+
+void RaJpegEncoder::run()
+{
+    RaJpegWorker worker;
+
+    for(;;) {
+        std::unique_ptr<Frame> frame;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _work.wait(lock, [this] { return _stop || !_queue.empty(); });
+
+            if(_queue.empty()) {
+                return;
+            }
+
+            frame = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        worker.row.resize((std::size_t)frame->width * 3);
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = compress(worker, *frame, _quality);
+        auto end = std::chrono::steady_clock::now();
+
+        const JOCTET *data = worker.buffer.data();
+        std::size_t size = worker.dest.size;
+
+        if(ok && !frame->path.empty()) {
+            FILE *file = std::fopen(frame->path.c_str(), "wb");
+            ok = file && std::fwrite(data, 1, size, file) == size;
+            if(file) {
+                ok = std::fclose(file) == 0 && ok;
+            }
+        }
+        else if(frame->callback) {
+            frame->callback(frame->userData, ok ? S_OK : E_FAIL,
+                    ok ? data : NULL, ok ? size : 0);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stats.frames += ok ? 1 : 0;
+            _stats.failed += ok ? 0 : 1;
+            _stats.bytes += ok ? size : 0;
+            _stats.encode_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    end - start).count();
+        }
+
+        recycle(std::move(frame));
+    }
+}
+
+static HRESULT copy_frame(RaJpegEncoder::Frame &frame, const void *pixels, int stride)
+{
+    const std::size_t pitch = (std::size_t)frame.width * 4;
+    const char *src = static_cast<const char*>(pixels);
+
+    if(stride == 0) {
+        stride = (int)pitch;
+    }
+
+    for(int y = 0; y < frame.height; ++y) {
+        std::memcpy(frame.pixels.data() + y * pitch, src + (std::size_t)y * stride, pitch);
+    }
+
+    return S_OK;
+}
+
+static HRESULT check_frame(RaJpegEncoder *encoder, const void *pixels, int width, int height,
+        int stride, uint32_t format)
+{
+    if(!encoder || !pixels) {
+        return c_error(E_INVALIDARG, "encoder or pixels is NULL");
+    }
+
+    if(width <= 0 || height <= 0) {
+        return c_error(E_INVALIDARG, "empty frame");
+    }
+
+    if(format != RA_PIXEL_BGRA8 && format != RA_PIXEL_RGBA8) {
+        return c_error(E_INVALIDARG, "only BGRA8 and RGBA8 frames can be encoded");
+    }
+
+    if(stride != 0 && stride < width * 4) {
+        return c_error(E_INVALIDARG, "stride is smaller than a row of the frame");
+    }
+
+    return S_OK;
+}
+
+CAPI_FUNC(RaJpegEncoder*) RaJpegEncoder_Create(int threads, int queue_size, int quality)
+{
+    if(quality < 1 || quality > 100) {
+        c_error(E_INVALIDARG, "quality must be in [1, 100]");
+        return NULL;
+    }
+
+    return new RaJpegEncoder(threads, queue_size, quality);
+}
+
+CAPI_FUNC(HRESULT) RaJpegEncoder_Destroy(RaJpegEncoder *encoder)
+{
+    if(!encoder) {
+        return c_error(E_INVALIDARG, "encoder is NULL");
+    }
+
+    RaJpegEncoder_Finish(encoder);
+
+    delete encoder;
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaJpegEncoder_EncodeFile(RaJpegEncoder *encoder, const void *pixels,
+        int width, int height, int stride, uint32_t format, uint32_t flags, const char *path)
+{
+    HRESULT result = check_frame(encoder, pixels, width, height, stride, format);
+    if(FAILED(result)) {
+        return result;
+    }
+
+    if(!path) {
+        return c_error(E_INVALIDARG, "path is NULL");
+    }
+
+    std::unique_ptr<RaJpegEncoder::Frame> frame = encoder->acquire(width, height);
+    frame->format = format;
+    frame->flags = flags;
+    frame->path = path;
+    copy_frame(*frame, pixels, stride);
+
+    encoder->submit(std::move(frame));
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaJpegEncoder_Encode(RaJpegEncoder *encoder, const void *pixels,
+        int width, int height, int stride, uint32_t format, uint32_t flags,
+        RaJpegCallback callback, void *user_data)
+{
+    HRESULT result = check_frame(encoder, pixels, width, height, stride, format);
+    if(FAILED(result)) {
+        return result;
+    }
+
+    if(!callback) {
+        return c_error(E_INVALIDARG, "callback is NULL");
+    }
+
+    std::unique_ptr<RaJpegEncoder::Frame> frame = encoder->acquire(width, height);
+    frame->format = format;
+    frame->flags = flags;
+    frame->callback = callback;
+    frame->userData = user_data;
+    copy_frame(*frame, pixels, stride);
+
+    encoder->submit(std::move(frame));
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaJpegEncoder_EncodeCanvas(RaJpegEncoder *encoder, RaCanvas *canvas,
+        const char *path)
+{
+    if(!encoder || !canvas) {
+        return c_error(E_INVALIDARG, "encoder or canvas is NULL");
+    }
+
+    // what the canvas shows, without asking for the surface to draw into,
+    // a producer thread draws into its own surface
+    cairo_surface_t *surface = canvas->threaded ? canvas->threaded->front() : canvas->surface;
+    if(!canvas->threaded) {
+        cairo_surface_flush(surface);
+    }
+
+    return RaJpegEncoder_EncodeFile(encoder, cairo_image_surface_get_data(surface),
+            cairo_image_surface_get_width(surface), cairo_image_surface_get_height(surface),
+            cairo_image_surface_get_stride(surface), RA_PIXEL_BGRA8,
+            RA_JPEG_UNPREMULTIPLY, path);
+}
+
+CAPI_FUNC(HRESULT) RaJpegEncoder_EncodeWindow(RaJpegEncoder *encoder, RaWindow *window,
+        const char *path)
+{
+    if(!encoder || !window || !path) {
+        return c_error(E_INVALIDARG, "encoder, window or path is NULL");
+    }
+
+    int width, height;
+    HRESULT result = RaWindow_GetFramebufferSize(window, &width, &height);
+    if(FAILED(result)) {
+        return result;
+    }
+
+    encoder->makeRoom(window);
+
+    std::unique_ptr<RaJpegEncoder::Frame> frame = encoder->acquire(width, height);
+    frame->path = path;
+
+    return encoder->readWindow(window, std::move(frame));
+}
+
+CAPI_FUNC(HRESULT) RaJpegEncoder_Finish(RaJpegEncoder *encoder)
+{
+    if(!encoder) {
+        return c_error(E_INVALIDARG, "encoder is NULL");
+    }
+
+    encoder->finishReads();
+    encoder->finish();
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaJpegEncoder_GetStats(RaJpegEncoder *encoder, RaJpegStats *stats)
+{
+    if(!encoder || !stats) {
+        return c_error(E_INVALIDARG, "encoder or stats is NULL");
+    }
+
+    *stats = encoder->stats();
+    return S_OK;
+}
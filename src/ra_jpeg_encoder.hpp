@@ -0,0 +1,160 @@
+/*
+ * ra_jpeg_encoder.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_JPEG_ENCODER_HPP_
+#define SRC_RA_JPEG_ENCODER_HPP_
+
+#include <ra_jpeg.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Pool of worker threads that encode frames to JPEG, this is also the
+ * RaJpegEncoder handle of the public API.
+ *
+ * Frames are taken from a free list, filled by the caller, and queued.
+ * At most capacity frames are out at once, counting the ones being filled,
+ * queued or encoded, so memory is bounded and acquire blocks when a caller
+ * gets ahead of the workers.
+ */
+struct RaJpegEncoder {
+public:
+
+    struct Frame {
+        RaJpegEncoder *owner;
+
+        /**
+         * tightly packed width x height pixels, 4 bytes each
+         */
+        std::vector<uint8_t> pixels;
+        int width;
+        int height;
+        uint32_t format;
+        uint32_t flags;
+
+        /**
+         * the JPEG goes to the file at path, or to callback if path is empty
+         */
+        std::string path;
+        RaJpegCallback callback;
+        void *userData;
+
+        /**
+         * window the frame is read from, NULL if it is filled by the caller
+         */
+        RaWindow *window;
+    };
+
+    /**
+     * threads and capacity are resolved to actual counts, quality is
+     * clamped to [1, 100].
+     */
+    RaJpegEncoder(int threads, int capacity, int quality);
+
+    /**
+     * encodes the queued frames and stops the workers.
+     */
+    ~RaJpegEncoder();
+
+    RaJpegEncoder(const RaJpegEncoder&) = delete;
+    RaJpegEncoder& operator=(const RaJpegEncoder&) = delete;
+
+    /**
+     * waits for room, then gets a frame sized for width x height pixels.
+     *
+     * @returns NULL if wait is false and there is no room.
+     */
+    std::unique_ptr<Frame> acquire(int width, int height, bool wait = true);
+
+    /**
+     * queues a filled frame for the workers.
+     */
+    void submit(std::unique_ptr<Frame> frame);
+
+    /**
+     * gives back a frame that will not be submitted.
+     */
+    void release(std::unique_ptr<Frame> frame);
+
+    /**
+     * blocks until every frame given out is done.
+     */
+    void finish();
+
+    RaJpegStats stats();
+
+    int capacity() const { return _capacity; }
+
+    /**
+     * reads the framebuffer of window into frame with
+     * RaWindow_ReadPixelsAsync, and queues the frame once the read is
+     * delivered. The frame is given back if the read fails.
+     */
+    HRESULT readWindow(RaWindow *window, std::unique_ptr<Frame> frame);
+
+    /**
+     * if every frame is out, delivers the reads of window, frames waiting
+     * for their read only come back when reads are delivered on this
+     * thread, so acquire would wait forever.
+     */
+    void makeRoom(RaWindow *window);
+
+    /**
+     * delivers the reads of every window, and gives back the frames of
+     * reads that can not be issued, so finish does not wait on them.
+     */
+    void finishReads();
+
+private:
+    static void frameRead(void *userData);
+
+    /**
+     * counts a read of window done or dropped, and forgets the window
+     * with its last one.
+     */
+    void readDone(RaWindow *window);
+
+    void run();
+
+    void recycle(std::unique_ptr<Frame> frame);
+
+    int _quality;
+    int _capacity;
+
+    std::mutex _mutex;
+    std::condition_variable _work;
+    std::condition_variable _room;
+    std::deque<std::unique_ptr<Frame>> _queue;
+    std::vector<std::unique_ptr<Frame>> _free;
+
+    /**
+     * frames given out and not yet back in the free list
+     */
+    int _out;
+    bool _stop;
+    RaJpegStats _stats;
+
+    std::vector<std::thread> _workers;
+
+    /**
+     * windows with reads for the encoder in flight, and how many, only
+     * used on the thread of the GL context. A window is dropped once its
+     * reads are delivered, which they all are before a window is
+     * destroyed, so none is left dangling.
+     */
+    std::map<RaWindow*, int> _windows;
+};
+
+#endif /* SRC_RA_JPEG_ENCODER_HPP_ */
@@ -0,0 +1,122 @@
+/*
+ * ra_mapped_file.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_mapped_file.hpp"
+#include <carbon.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+RaMappedFile::RaMappedFile(): _data{NULL}, _size{0}, _file{NULL}, _mapping{NULL}
+{
+}
+
+HRESULT RaMappedFile::open(const char *path)
+{
+    close();
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) {
+        return c_error(E_FAIL, "could not open file");
+    }
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return c_error(E_FAIL, "could not map empty file");
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const void *data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if(!data) {
+        if(mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return c_error(E_FAIL, "could not map file");
+    }
+
+    _file = file;
+    _mapping = mapping;
+    _data = (const char*)data;
+    _size = (std::size_t)size.QuadPart;
+    return S_OK;
+}
+
+void RaMappedFile::close()
+{
+    if(_data) {
+        UnmapViewOfFile(_data);
+        CloseHandle((HANDLE)_mapping);
+        CloseHandle((HANDLE)_file);
+    }
+
+    _data = NULL;
+    _size = 0;
+    _file = NULL;
+    _mapping = NULL;
+}
+
+#else
+
+RaMappedFile::RaMappedFile(): _data{NULL}, _size{0}
+{
+}
+
+HRESULT RaMappedFile::open(const char *path)
+{
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if(fd < 0) {
+        return c_error(E_FAIL, "could not open file");
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return c_error(E_FAIL, "could not map empty file");
+    }
+
+    // the mapping keeps the file open on its own
+    void *data = mmap(NULL, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if(data == MAP_FAILED) {
+        return c_error(E_FAIL, "could not map file");
+    }
+
+    _data = (const char*)data;
+    _size = (std::size_t)st.st_size;
+    return S_OK;
+}
+
+void RaMappedFile::close()
+{
+    if(_data) {
+        munmap((void*)_data, _size);
+    }
+
+    _data = NULL;
+    _size = 0;
+}
+
+#endif
+
+RaMappedFile::~RaMappedFile()
+{
+    close();
+}
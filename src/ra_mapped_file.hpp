@@ -0,0 +1,56 @@
+/*
+ * ra_mapped_file.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_MAPPED_FILE_HPP_
+#define SRC_RA_MAPPED_FILE_HPP_
+
+#include <c_port.h>
+
+#include <cstddef>
+
+/**
+ * A whole file mapped read only into memory.
+ *
+ * Pages are read in by the OS as they are touched, so opening is cheap no
+ * matter the size, and the data can be handed to GL, or a decoder, in
+ * place without a copy on the heap.
+ */
+class RaMappedFile {
+public:
+
+    RaMappedFile();
+
+    /**
+     * unmaps the file.
+     */
+    ~RaMappedFile();
+
+    RaMappedFile(const RaMappedFile&) = delete;
+    RaMappedFile& operator=(const RaMappedFile&) = delete;
+
+    /**
+     * maps the file at path, empty files can not be mapped.
+     */
+    HRESULT open(const char *path);
+
+    void close();
+
+    const char *data() const { return _data; }
+
+    std::size_t size() const { return _size; }
+
+private:
+    const char *_data;
+    std::size_t _size;
+
+#if defined(_WIN32)
+    void *_file;
+    void *_mapping;
+#endif
+};
+
+#endif /* SRC_RA_MAPPED_FILE_HPP_ */
@@ -0,0 +1,204 @@
+/*
+ * ra_mipmap.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_mipmap.hpp"
+#include "ra_simd.hpp"
+
+#include <algorithm>
+
+#ifdef RA_SIMD_X86
+#include <immintrin.h>
+#endif
+
+static void downsample_scalar(const uint8_t *row0, const uint8_t *row1,
+        uint8_t *dst, std::size_t count)
+{
+    for(std::size_t i = 0; i < count; ++i) {
+        for(int c = 0; c < 4; ++c) {
+            unsigned sum = row0[8 * i + c] + row0[8 * i + 4 + c] +
+                           row1[8 * i + c] + row1[8 * i + 4 + c];
+            dst[4 * i + c] = (uint8_t)((sum + 2) >> 2);
+        }
+    }
+}
+
+#ifdef RA_SIMD_X86
+
+/**
+ * 4 source pixels of each row to 2 output pixels, in the low 8 bytes
+ */
+RA_TARGET_SSE2 static inline __m128i downsample2px_sse2(__m128i a, __m128i b)
+{
+    const __m128i zero = _mm_setzero_si128();
+    // vertical sums, 16 bits per channel, pixels 0 1 in lo, 2 3 in hi
+    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+    // horizontal pairs, 0 + 1 and 2 + 3
+    __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+    sum = _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+    return _mm_packus_epi16(sum, sum);
+}
+
+RA_TARGET_SSE2 static void downsample_sse2(const uint8_t *row0, const uint8_t *row1,
+        uint8_t *dst, std::size_t count)
+{
+    std::size_t i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128i p = downsample2px_sse2(_mm_loadu_si128((const __m128i*)(row0 + 8 * i)),
+                                       _mm_loadu_si128((const __m128i*)(row1 + 8 * i)));
+        __m128i q = downsample2px_sse2(_mm_loadu_si128((const __m128i*)(row0 + 8 * i + 16)),
+                                       _mm_loadu_si128((const __m128i*)(row1 + 8 * i + 16)));
+        _mm_storeu_si128((__m128i*)(dst + 4 * i), _mm_unpacklo_epi64(p, q));
+    }
+    downsample_scalar(row0 + 8 * i, row1 + 8 * i, dst + 4 * i, count - i);
+}
+
+#endif
+
+RaDownsampleRow RaMipmap_DownsampleRowScalar()
+{
+    return downsample_scalar;
+}
+
+RaDownsampleRow RaMipmap_DownsampleRow()
+{
+#ifdef RA_SIMD_X86
+    if(RaSimd_Supports(RA_SIMD_SSE2)) {
+        return downsample_sse2;
+    }
+#endif
+    return downsample_scalar;
+}
+
+int RaMipmap_LevelCount(int width, int height)
+{
+    int size = std::max(width, height);
+    int levels = 1;
+    while(size > 1) {
+        size /= 2;
+        levels += 1;
+    }
+    return levels;
+}
+
+RaMipChain::RaMipChain(int width, int height):
+    _width{width}, _height{height}, _downsample{RaMipmap_DownsampleRow()}
+{
+    while(width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        _levels.push_back({width, height,
+            std::vector<uint8_t>((std::size_t)width * height * 4)});
+    }
+}
+
+/**
+ * filters one output pixel with the source coordinates clamped, for
+ * levels where one side is already 1 pixel.
+ */
+static void downsample_clamped(const uint8_t *src, int srcStride, int srcWidth, int srcHeight,
+        uint8_t *dst, int x, int y)
+{
+    int x0 = std::min(2 * x, srcWidth - 1), x1 = std::min(2 * x + 1, srcWidth - 1);
+    int y0 = std::min(2 * y, srcHeight - 1), y1 = std::min(2 * y + 1, srcHeight - 1);
+    for(int c = 0; c < 4; ++c) {
+        unsigned sum = src[y0 * srcStride + 4 * x0 + c] + src[y0 * srcStride + 4 * x1 + c] +
+                       src[y1 * srcStride + 4 * x0 + c] + src[y1 * srcStride + 4 * x1 + c];
+        dst[c] = (uint8_t)((sum + 2) >> 2);
+    }
+}
+
+bool RaMipChain::filter(Level &level, const uint8_t *src, int srcStride, int srcWidth,
+        int srcHeight, const RaRect &r, RaRect &changed)
+{
+    const int dstStride = level.width * 4;
+    const bool clamped = 2 * level.width > srcWidth || 2 * level.height > srcHeight;
+
+    // the level pixels that any changed source pixel feeds
+    int x0 = r.x / 2, y0 = r.y / 2;
+    int x1 = std::min(level.width, (r.x + r.w + 1) / 2);
+    int y1 = std::min(level.height, (r.y + r.h + 1) / 2);
+    if(x1 <= x0 || y1 <= y0) {
+        return false;
+    }
+
+    for(int y = y0; y < y1; ++y) {
+        uint8_t *dst = level.pixels.data() + (std::size_t)y * dstStride;
+        if(clamped) {
+            for(int x = x0; x < x1; ++x) {
+                downsample_clamped(src, srcStride, srcWidth, srcHeight, dst + 4 * x, x, y);
+            }
+        }
+        else {
+            const uint8_t *row0 = src + (std::size_t)(2 * y) * srcStride + 8 * x0;
+            _downsample(row0, row0 + srcStride, dst + 4 * x0, x1 - x0);
+        }
+    }
+
+    changed = {x0, y0, x1 - x0, y1 - y0};
+    return true;
+}
+
+void RaMipChain::build(const uint8_t *level0, int stride)
+{
+    const uint8_t *src = level0;
+    int srcStride = stride;
+    int srcWidth = _width;
+    int srcHeight = _height;
+
+    for(Level &level : _levels) {
+        RaRect changed;
+        filter(level, src, srcStride, srcWidth, srcHeight,
+               {0, 0, srcWidth, srcHeight}, changed);
+
+        src = level.pixels.data();
+        srcStride = level.width * 4;
+        srcWidth = level.width;
+        srcHeight = level.height;
+    }
+}
+
+void RaMipChain::update(Magnum::GL::Texture2D &texture, const RaPixelSource &level0,
+        const RaRect *rects, int count, RaUploadStats &stats)
+{
+    // the source level, starting with the surface
+    const uint8_t *src = (const uint8_t*)level0.data;
+    int srcStride = level0.row_length * level0.pixel_size;
+    int srcWidth = _width;
+    int srcHeight = _height;
+
+    std::vector<RaRect> current(rects, rects + count);
+    std::vector<RaRect> next;
+
+    for(int l = 0; l < (int)_levels.size(); ++l) {
+        Level &level = _levels[l];
+        int dstStride = level.width * 4;
+
+        next.clear();
+        for(const RaRect &r : current) {
+            RaRect changed;
+            if(filter(level, src, srcStride, srcWidth, srcHeight, r, changed)) {
+                next.push_back(changed);
+            }
+        }
+
+        RaPixelSource source;
+        source.data = level.pixels.data();
+        source.size = level.pixels.size();
+        source.row_length = level.width;
+        source.pixel_size = 4;
+        source.format = level0.format;
+        source.type = level0.type;
+        RaUpload_Direct(texture, source, next.data(), (int)next.size(), stats, l + 1);
+
+        current.swap(next);
+        src = level.pixels.data();
+        srcStride = dstStride;
+        srcWidth = level.width;
+        srcHeight = level.height;
+    }
+}
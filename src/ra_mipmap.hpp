@@ -0,0 +1,108 @@
+/*
+ * ra_mipmap.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_MIPMAP_HPP_
+#define SRC_RA_MIPMAP_HPP_
+
+#include "ra_damage.hpp"
+#include "ra_upload.hpp"
+
+#include <Magnum/GL/Texture.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * box filters count 2x2 blocks of BGRA8 pixels from two source rows into
+ * count pixels of dst, rounding to nearest.
+ */
+typedef void (*RaDownsampleRow)(const uint8_t *row0, const uint8_t *row1,
+        uint8_t *dst, std::size_t count);
+
+/**
+ * the fastest downsampler for this CPU, SSE2 or scalar.
+ */
+RaDownsampleRow RaMipmap_DownsampleRow();
+
+/**
+ * the scalar downsampler, for testing and comparison with the SIMD path.
+ */
+RaDownsampleRow RaMipmap_DownsampleRowScalar();
+
+/**
+ * number of levels in a full mip chain down to 1x1.
+ */
+int RaMipmap_LevelCount(int width, int height);
+
+/**
+ * CPU copies of the mip levels of a surface, below level 0, which is the
+ * surface itself.
+ *
+ * Only the parts of each level under the changed rects of level 0 are
+ * filtered again and uploaded, so a small change costs a small, shrinking
+ * rect per level instead of a glGenerateMipmap over the whole texture.
+ * Level sizes are halved and rounded down, as GL does.
+ */
+class RaMipChain {
+public:
+
+    /**
+     * chain for a level 0 of width x height pixels, usually the storage
+     * size of the texture.
+     */
+    RaMipChain(int width, int height);
+
+    /**
+     * levels, including level 0.
+     */
+    int levels() const { return (int)_levels.size() + 1; }
+
+    /**
+     * filters the rects of level 0 down the chain, and uploads the changed
+     * parts of levels 1 and up to the texture. Level 0 itself is not
+     * uploaded, its data must cover the full size of the chain.
+     */
+    void update(Magnum::GL::Texture2D &texture, const RaPixelSource &level0,
+            const RaRect *rects, int count, RaUploadStats &stats);
+
+    /**
+     * filters all of level 0, rows stride bytes apart, down the chain
+     * without uploading, i.e. to write the levels to a file.
+     */
+    void build(const uint8_t *level0, int stride);
+
+    /**
+     * pixels of a level below level 0, tightly packed 4 byte pixels.
+     */
+    const uint8_t *levelData(int level) const { return _levels[level - 1].pixels.data(); }
+    int levelWidth(int level) const { return level ? _levels[level - 1].width : _width; }
+    int levelHeight(int level) const { return level ? _levels[level - 1].height : _height; }
+
+private:
+    struct Level {
+        int width;
+        int height;
+        std::vector<uint8_t> pixels;
+    };
+
+    /**
+     * filters the level pixels under a rect of the level above it.
+     *
+     * @returns false if the rect covers no pixel of the level, else the
+     * rect of the level that changed.
+     */
+    bool filter(Level &level, const uint8_t *src, int srcStride, int srcWidth, int srcHeight,
+            const RaRect &r, RaRect &changed);
+
+    int _width;
+    int _height;
+    std::vector<Level> _levels;
+    RaDownsampleRow _downsample;
+};
+
+#endif /* SRC_RA_MIPMAP_HPP_ */
@@ -0,0 +1,103 @@
+/*
+ * ra_persistent_surface.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_persistent_surface.hpp"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/PixelStorage.h>
+#include <Magnum/GL/BufferImage.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/PixelFormat.h>
+
+using namespace Magnum;
+
+bool RaPersistentSurface::isSupported()
+{
+    return GL::Context::current().isExtensionSupported<GL::Extensions::ARB::buffer_storage>();
+}
+
+RaPersistentSurface::RaPersistentSurface(int width, int height, int count):
+    _current{0}, _width{width}, _height{height}
+{
+    _stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+
+    std::size_t size = (std::size_t)_stride * height;
+
+    _buffers.reserve(count);
+
+    for(int i = 0; i < count; ++i) {
+        Buffer b{GL::Buffer{GL::Buffer::TargetHint::PixelUnpack}, nullptr, nullptr, RaFence{}};
+
+        b.buffer.setStorage({nullptr, size},
+                GL::Buffer::StorageFlag::MapWrite |
+                GL::Buffer::StorageFlag::MapPersistent |
+                GL::Buffer::StorageFlag::MapCoherent);
+
+        Containers::ArrayView<char> data = b.buffer.map(0, size,
+                GL::Buffer::MapFlag::Write |
+                GL::Buffer::MapFlag::Persistent |
+                GL::Buffer::MapFlag::Coherent);
+
+        b.surface = cairo_image_surface_create_for_data((unsigned char*)data.data(),
+                CAIRO_FORMAT_ARGB32, width, height, _stride);
+
+        b.cr = cairo_create(b.surface);
+
+        _buffers.push_back(std::move(b));
+    }
+}
+
+RaPersistentSurface::~RaPersistentSurface()
+{
+    for(Buffer &b : _buffers) {
+        // GPU might still be reading, and the buffer storage goes away with
+        // the buffer.
+        b.fence.wait(~uint64_t{0});
+        cairo_destroy(b.cr);
+        cairo_surface_destroy(b.surface);
+        b.buffer.unmap();
+    }
+}
+
+HRESULT RaPersistentSurface::flush(GL::Texture2D &texture, RaUploadStats &stats)
+{
+    Buffer &b = _buffers[_current];
+
+    cairo_surface_flush(b.surface);
+
+    std::size_t size = (std::size_t)_stride * _height;
+
+    PixelStorage storage;
+    storage.setRowLength(_stride / 4);
+
+    // lend the buffer to a buffer image for the transfer, and take it back,
+    // it stays mapped the whole time.
+    GL::BufferImage2D image{storage, GL::PixelFormat::BGRA, GL::PixelType::UnsignedByte,
+        {_width, _height}, std::move(b.buffer), size};
+
+    texture.setSubImage(0, {}, image);
+
+    b.buffer = image.release();
+
+    b.fence.insert();
+
+    stats.uploads += 1;
+    stats.bytes += size;
+
+    _current = (_current + 1) % (int)_buffers.size();
+
+    // cairo is about to draw into the next buffer, it must not be in
+    // flight. Only blocks if the GPU is more than count - 1 frames behind.
+    Buffer &next = _buffers[_current];
+    if(!next.fence.signaled()) {
+        stats.starved += 1;
+        next.fence.wait(~uint64_t{0});
+    }
+
+    return S_OK;
+}
@@ -0,0 +1,77 @@
+/*
+ * ra_persistent_surface.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_PERSISTENT_SURFACE_HPP_
+#define SRC_RA_PERSISTENT_SURFACE_HPP_
+
+#include <cairo.h>
+#include <c_port.h>
+#include <ra_upload.h>
+#include "ra_fence.hpp"
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Texture.h>
+
+#include <vector>
+
+/**
+ * Set of cairo image surfaces that draw directly into persistently mapped
+ * GL buffers.
+ *
+ * Cairo draws into GPU visible memory, so flushing is just a transfer from
+ * the buffer to the texture, no copy on the CPU. The buffers are used in
+ * turn like a swap chain, each flush fences the buffer just drawn and
+ * moves on to the next, waiting only if the GPU is still reading it.
+ *
+ * Because each frame goes to a different buffer, the surface contents
+ * after a flush are those of several frames ago, every frame has to be
+ * completely redrawn.
+ */
+class RaPersistentSurface {
+public:
+
+    /**
+     * is persistent buffer mapping supported by the current context.
+     */
+    static bool isSupported();
+
+    RaPersistentSurface(int width, int height, int count);
+
+    ~RaPersistentSurface();
+
+    RaPersistentSurface(const RaPersistentSurface&) = delete;
+    RaPersistentSurface& operator=(const RaPersistentSurface&) = delete;
+
+    /**
+     * the surface to draw the current frame into
+     */
+    cairo_surface_t *surface() const { return _buffers[_current].surface; }
+
+    cairo_t *cr() const { return _buffers[_current].cr; }
+
+    /**
+     * transfers the current surface to the texture, and moves to the next
+     * buffer.
+     */
+    HRESULT flush(Magnum::GL::Texture2D &texture, RaUploadStats &stats);
+
+private:
+    struct Buffer {
+        Magnum::GL::Buffer buffer;
+        cairo_surface_t *surface;
+        cairo_t *cr;
+        RaFence fence;
+    };
+
+    std::vector<Buffer> _buffers;
+    int _current;
+    int _width;
+    int _height;
+    int _stride;
+};
+
+#endif /* SRC_RA_PERSISTENT_SURFACE_HPP_ */
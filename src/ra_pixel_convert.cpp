@@ -0,0 +1,408 @@
+/*
+ * ra_pixel_convert.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_pixel_convert.hpp"
+#include "ra_simd.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifdef RA_SIMD_X86
+#include <immintrin.h>
+#endif
+
+/*
+ * gray is expanded to b = g = r = gray, a = 255, written as one little
+ * endian 32 bit word: 0xff000000 | g << 16 | g << 8 | g
+ */
+
+static inline uint32_t gray_pixel(uint32_t g) {
+    return 0xff000000u | (g << 16) | (g << 8) | g;
+}
+
+static inline uint32_t float_to_unorm8(float f) {
+    // written so that NaN goes to 0
+    if(!(f > 0.f)) return 0;
+    if(f >= 1.f) return 255;
+    return (uint32_t)(f * 255.f + 0.5f);
+}
+
+static void gray8_scalar(const void *_src, void *_dst, std::size_t count)
+{
+    const uint8_t *src = (const uint8_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    for(std::size_t i = 0; i < count; ++i) {
+        uint32_t p = gray_pixel(src[i]);
+        std::memcpy(dst + 4 * i, &p, 4);
+    }
+}
+
+static void gray16_scalar(const void *_src, void *_dst, std::size_t count)
+{
+    const uint16_t *src = (const uint16_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    for(std::size_t i = 0; i < count; ++i) {
+        uint32_t p = gray_pixel(src[i] >> 8);
+        std::memcpy(dst + 4 * i, &p, 4);
+    }
+}
+
+static void grayf32_scalar(const void *_src, void *_dst, std::size_t count)
+{
+    const float *src = (const float*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    for(std::size_t i = 0; i < count; ++i) {
+        uint32_t p = gray_pixel(float_to_unorm8(src[i]));
+        std::memcpy(dst + 4 * i, &p, 4);
+    }
+}
+
+/*
+ * premultiplied colors are scaled by 255 / alpha in float, rounded to
+ * nearest even, the same as the SIMD code, so both give the same bytes.
+ */
+static void unpremultiply_scalar(const void *_src, void *_dst, std::size_t count)
+{
+    const uint8_t *src = (const uint8_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    for(std::size_t i = 0; i < count; ++i) {
+        const uint8_t *s = src + 4 * i;
+        uint8_t *d = dst + 4 * i;
+        uint8_t a = s[3];
+        if(a == 255) {
+            std::memmove(d, s, 4);
+            continue;
+        }
+        if(a == 0) {
+            std::memset(d, 0, 4);
+            continue;
+        }
+        float scale = 255.f / (float)a;
+        for(int c = 0; c < 3; ++c) {
+            long v = std::lrint((float)s[c] * scale);
+            d[c] = (uint8_t)(v > 255 ? 255 : v);
+        }
+        d[3] = a;
+    }
+}
+
+/*
+ * 4 byte pixels to 3 byte ones, r, g, b in memory order, from BGRA or RGBA
+ */
+static void bgra_to_rgb_scalar(const void *_src, void *_dst, std::size_t count)
+{
+    const uint8_t *src = (const uint8_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    for(std::size_t i = 0; i < count; ++i) {
+        dst[3 * i + 0] = src[4 * i + 2];
+        dst[3 * i + 1] = src[4 * i + 1];
+        dst[3 * i + 2] = src[4 * i + 0];
+    }
+}
+
+static void rgba_to_rgb_scalar(const void *_src, void *_dst, std::size_t count)
+{
+    const uint8_t *src = (const uint8_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    for(std::size_t i = 0; i < count; ++i) {
+        dst[3 * i + 0] = src[4 * i + 0];
+        dst[3 * i + 1] = src[4 * i + 1];
+        dst[3 * i + 2] = src[4 * i + 2];
+    }
+}
+
+#ifdef RA_SIMD_X86
+
+/**
+ * un-premultiplies one pixel, as 4 floats b g r a
+ */
+RA_TARGET_SSE2 static inline __m128 unpremultiply1px_sse2(__m128 p)
+{
+    __m128 alpha = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3));
+    __m128 scaled = _mm_mul_ps(p, _mm_div_ps(_mm_set1_ps(255.f), alpha));
+    // alpha itself is kept, zero alpha gives 0 instead of NaN
+    const __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    scaled = _mm_or_ps(_mm_and_ps(colorMask, scaled), _mm_andnot_ps(colorMask, p));
+    return _mm_and_ps(scaled, _mm_cmpneq_ps(alpha, _mm_setzero_ps()));
+}
+
+RA_TARGET_SSE2 static void unpremultiply_sse2(const void *_src, void *_dst, std::size_t count)
+{
+    const uint8_t *src = (const uint8_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32((int)0xff000000);
+
+    std::size_t i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)(src + 4 * i));
+
+        // opaque pixels, most of a frame, stay as they are
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(p, alphaMask), alphaMask)) == 0xffff) {
+            _mm_storeu_si128((__m128i*)(dst + 4 * i), p);
+            continue;
+        }
+
+        __m128i lo = _mm_unpacklo_epi8(p, zero);
+        __m128i hi = _mm_unpackhi_epi8(p, zero);
+
+        __m128i p0 = _mm_cvtps_epi32(unpremultiply1px_sse2(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero))));
+        __m128i p1 = _mm_cvtps_epi32(unpremultiply1px_sse2(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero))));
+        __m128i p2 = _mm_cvtps_epi32(unpremultiply1px_sse2(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero))));
+        __m128i p3 = _mm_cvtps_epi32(unpremultiply1px_sse2(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero))));
+
+        __m128i out = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+        _mm_storeu_si128((__m128i*)(dst + 4 * i), out);
+    }
+    unpremultiply_scalar(src + 4 * i, dst + 4 * i, count - i);
+}
+
+/**
+ * 4 byte pixels to 3 byte ones with a byte shuffle, 4 pixels at a time.
+ * Each store writes 16 bytes for 12, the next one overwrites the rest, so
+ * the last pixels are done by the scalar code.
+ */
+RA_TARGET_SSSE3 static inline void to_rgb_ssse3(const uint8_t *src, uint8_t *dst,
+        std::size_t &i, std::size_t count, __m128i shuffle)
+{
+    for(; i + 6 <= count; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)(src + 4 * i));
+        _mm_storeu_si128((__m128i*)(dst + 3 * i), _mm_shuffle_epi8(p, shuffle));
+    }
+}
+
+RA_TARGET_SSSE3 static void bgra_to_rgb_ssse3(const void *_src, void *_dst, std::size_t count)
+{
+    const uint8_t *src = (const uint8_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+            -1, -1, -1, -1);
+    std::size_t i = 0;
+    to_rgb_ssse3(src, dst, i, count, shuffle);
+    bgra_to_rgb_scalar(src + 4 * i, dst + 3 * i, count - i);
+}
+
+RA_TARGET_SSSE3 static void rgba_to_rgb_ssse3(const void *_src, void *_dst, std::size_t count)
+{
+    const uint8_t *src = (const uint8_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+            -1, -1, -1, -1);
+    std::size_t i = 0;
+    to_rgb_ssse3(src, dst, i, count, shuffle);
+    rgba_to_rgb_scalar(src + 4 * i, dst + 3 * i, count - i);
+}
+
+/**
+ * expands 16 gray bytes to 16 BGRA pixels
+ */
+RA_TARGET_SSE2 static inline void gray16px_sse2(__m128i g, uint8_t *dst)
+{
+    const __m128i alpha = _mm_set1_epi8((char)0xff);
+    __m128i gg_lo = _mm_unpacklo_epi8(g, g);      // g0 g0 g1 g1 ...
+    __m128i ga_lo = _mm_unpacklo_epi8(g, alpha);  // g0 ff g1 ff ...
+    __m128i gg_hi = _mm_unpackhi_epi8(g, g);
+    __m128i ga_hi = _mm_unpackhi_epi8(g, alpha);
+    _mm_storeu_si128((__m128i*)(dst +  0), _mm_unpacklo_epi16(gg_lo, ga_lo));
+    _mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(gg_lo, ga_lo));
+    _mm_storeu_si128((__m128i*)(dst + 32), _mm_unpacklo_epi16(gg_hi, ga_hi));
+    _mm_storeu_si128((__m128i*)(dst + 48), _mm_unpackhi_epi16(gg_hi, ga_hi));
+}
+
+RA_TARGET_SSE2 static void gray8_sse2(const void *_src, void *_dst, std::size_t count)
+{
+    const uint8_t *src = (const uint8_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    std::size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        gray16px_sse2(_mm_loadu_si128((const __m128i*)(src + i)), dst + 4 * i);
+    }
+    gray8_scalar(src + i, dst + 4 * i, count - i);
+}
+
+RA_TARGET_SSE2 static void gray16_sse2(const void *_src, void *_dst, std::size_t count)
+{
+    const uint16_t *src = (const uint16_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    std::size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m128i a = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(src + i)), 8);
+        __m128i b = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(src + i + 8)), 8);
+        gray16px_sse2(_mm_packus_epi16(a, b), dst + 4 * i);
+    }
+    gray16_scalar(src + i, dst + 4 * i, count - i);
+}
+
+RA_TARGET_SSE2 static void grayf32_sse2(const void *_src, void *_dst, std::size_t count)
+{
+    const float *src = (const float*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 scale = _mm_set1_ps(255.f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+    std::size_t i = 0;
+    for(; i + 4 <= count; i += 4) {
+        // max(x, 0) with x first returns 0 for NaN
+        __m128 f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), zero), one);
+        __m128i g = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f, scale), half));
+        __m128i p = _mm_or_si128(_mm_or_si128(g, _mm_slli_epi32(g, 8)),
+                                 _mm_or_si128(_mm_slli_epi32(g, 16), alpha));
+        _mm_storeu_si128((__m128i*)(dst + 4 * i), p);
+    }
+    grayf32_scalar(src + i, dst + 4 * i, count - i);
+}
+
+/**
+ * expands 8 gray values, one per 32 bit lane, to 8 BGRA pixels
+ */
+RA_TARGET_AVX2 static inline void gray8px_avx2(__m256i g, uint8_t *dst)
+{
+    const __m256i alpha = _mm256_set1_epi32((int)0xff000000);
+    __m256i p = _mm256_or_si256(_mm256_or_si256(g, _mm256_slli_epi32(g, 8)),
+                                _mm256_or_si256(_mm256_slli_epi32(g, 16), alpha));
+    _mm256_storeu_si256((__m256i*)dst, p);
+}
+
+RA_TARGET_AVX2 static void gray8_avx2(const void *_src, void *_dst, std::size_t count)
+{
+    const uint8_t *src = (const uint8_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    std::size_t i = 0;
+    for(; i + 32 <= count; i += 32) {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(src + i + 16));
+        gray8px_avx2(_mm256_cvtepu8_epi32(lo), dst + 4 * i);
+        gray8px_avx2(_mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)), dst + 4 * i + 32);
+        gray8px_avx2(_mm256_cvtepu8_epi32(hi), dst + 4 * i + 64);
+        gray8px_avx2(_mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)), dst + 4 * i + 96);
+    }
+    gray8_scalar(src + i, dst + 4 * i, count - i);
+}
+
+RA_TARGET_AVX2 static void gray16_avx2(const void *_src, void *_dst, std::size_t count)
+{
+    const uint16_t *src = (const uint16_t*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    std::size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+        __m256i b = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i + 8)));
+        gray8px_avx2(_mm256_srli_epi32(a, 8), dst + 4 * i);
+        gray8px_avx2(_mm256_srli_epi32(b, 8), dst + 4 * i + 32);
+    }
+    gray16_scalar(src + i, dst + 4 * i, count - i);
+}
+
+RA_TARGET_AVX2 static void grayf32_avx2(const void *_src, void *_dst, std::size_t count)
+{
+    const float *src = (const float*)_src;
+    uint8_t *dst = (uint8_t*)_dst;
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 scale = _mm256_set1_ps(255.f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    std::size_t i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 f = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), zero), one);
+        gray8px_avx2(_mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(f, scale), half)), dst + 4 * i);
+    }
+    grayf32_scalar(src + i, dst + 4 * i, count - i);
+}
+
+#endif
+
+int RaPixelFormat_Size(uint32_t format)
+{
+    switch(format) {
+        case RA_PIXEL_BGRA8:   return 4;
+        case RA_PIXEL_RGBA8:   return 4;
+        case RA_PIXEL_RGB8:    return 3;
+        case RA_PIXEL_BGR8:    return 3;
+        case RA_PIXEL_GRAY8:   return 1;
+        case RA_PIXEL_GRAY16:  return 2;
+        case RA_PIXEL_RGBA16:  return 8;
+        case RA_PIXEL_GRAYF32: return 4;
+        case RA_PIXEL_RGBAF32: return 16;
+        default:               return 0;
+    }
+}
+
+RaPixelConverter RaPixelConvert_ToBGRA8Scalar(uint32_t format)
+{
+    switch(format) {
+        case RA_PIXEL_GRAY8:   return gray8_scalar;
+        case RA_PIXEL_GRAY16:  return gray16_scalar;
+        case RA_PIXEL_GRAYF32: return grayf32_scalar;
+        default:               return NULL;
+    }
+}
+
+RaPixelConverter RaPixelConvert_ToBGRA8(uint32_t format)
+{
+#ifdef RA_SIMD_X86
+    if(RaSimd_Supports(RA_SIMD_AVX2)) {
+        switch(format) {
+            case RA_PIXEL_GRAY8:   return gray8_avx2;
+            case RA_PIXEL_GRAY16:  return gray16_avx2;
+            case RA_PIXEL_GRAYF32: return grayf32_avx2;
+            default:               break;
+        }
+    }
+
+    if(RaSimd_Supports(RA_SIMD_SSE2)) {
+        switch(format) {
+            case RA_PIXEL_GRAY8:   return gray8_sse2;
+            case RA_PIXEL_GRAY16:  return gray16_sse2;
+            case RA_PIXEL_GRAYF32: return grayf32_sse2;
+            default:               break;
+        }
+    }
+#endif
+
+    return RaPixelConvert_ToBGRA8Scalar(format);
+}
+
+RaPixelConverter RaPixelConvert_UnpremultiplyScalar()
+{
+    return unpremultiply_scalar;
+}
+
+RaPixelConverter RaPixelConvert_Unpremultiply()
+{
+#ifdef RA_SIMD_X86
+    if(RaSimd_Supports(RA_SIMD_SSE2)) {
+        return unpremultiply_sse2;
+    }
+#endif
+    return unpremultiply_scalar;
+}
+
+RaPixelConverter RaPixelConvert_ToRGB8Scalar(uint32_t format)
+{
+    switch(format) {
+        case RA_PIXEL_BGRA8: return bgra_to_rgb_scalar;
+        case RA_PIXEL_RGBA8: return rgba_to_rgb_scalar;
+        default:             return NULL;
+    }
+}
+
+RaPixelConverter RaPixelConvert_ToRGB8(uint32_t format)
+{
+#ifdef RA_SIMD_X86
+    if(RaSimd_Supports(RA_SIMD_SSSE3)) {
+        switch(format) {
+            case RA_PIXEL_BGRA8: return bgra_to_rgb_ssse3;
+            case RA_PIXEL_RGBA8: return rgba_to_rgb_ssse3;
+            default:             break;
+        }
+    }
+#endif
+    return RaPixelConvert_ToRGB8Scalar(format);
+}
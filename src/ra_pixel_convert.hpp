@@ -0,0 +1,58 @@
+/*
+ * ra_pixel_convert.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_PIXEL_CONVERT_HPP_
+#define SRC_RA_PIXEL_CONVERT_HPP_
+
+#include <ra_upload.h>
+#include <cstddef>
+
+/**
+ * converts count pixels from src to tightly packed BGRA8 in dst, or to
+ * another format for the converters that say so.
+ */
+typedef void (*RaPixelConverter)(const void *src, void *dst, std::size_t count);
+
+/**
+ * bytes per pixel of a RaPixelFormat, 0 for planar YUV formats or if the
+ * format is unknown.
+ */
+int RaPixelFormat_Size(uint32_t format);
+
+/**
+ * Gets the fastest converter from a RaPixelFormat to BGRA8 for this CPU,
+ * picks AVX2, SSE2 or scalar code at runtime.
+ *
+ * @returns NULL for formats that GL uploads directly, or unknown formats.
+ */
+RaPixelConverter RaPixelConvert_ToBGRA8(uint32_t format);
+
+/**
+ * the scalar converter for a format, for testing and comparison with the
+ * SIMD paths.
+ */
+RaPixelConverter RaPixelConvert_ToBGRA8Scalar(uint32_t format);
+
+/**
+ * Gets the fastest converter from premultiplied BGRA8 or RGBA8 to straight
+ * alpha for this CPU, SSE2 or scalar. src and dst may be the same.
+ */
+RaPixelConverter RaPixelConvert_Unpremultiply();
+
+RaPixelConverter RaPixelConvert_UnpremultiplyScalar();
+
+/**
+ * Gets the fastest converter from BGRA8 or RGBA8 to RGB8, dropping alpha,
+ * for this CPU, SSSE3 or scalar.
+ *
+ * @returns NULL for other formats.
+ */
+RaPixelConverter RaPixelConvert_ToRGB8(uint32_t format);
+
+RaPixelConverter RaPixelConvert_ToRGB8Scalar(uint32_t format);
+
+#endif /* SRC_RA_PIXEL_CONVERT_HPP_ */
@@ -0,0 +1,329 @@
+/*
+ * ra_program_cache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_program_cache.hpp"
+#include <carbon.h>
+
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace Magnum;
+
+namespace fs = std::filesystem;
+
+typedef std::chrono::steady_clock Clock;
+
+static uint64_t nanoseconds(Clock::duration time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+/**
+ * bumped when the file layout changes, it is part of the key, so old
+ * files are never read.
+ */
+static const uint32_t FileVersion = 1;
+
+/**
+ * each file is a header of "RAPB", the version, the binary format and the
+ * binary size, as native uint32, followed by the binary.
+ */
+static const std::size_t HeaderSize = 16;
+
+static std::string default_directory()
+{
+    if(const char *env = std::getenv("RADIUM_SHADER_CACHE")) {
+        return env;
+    }
+
+#if defined(_WIN32)
+    const char *base = std::getenv("LOCALAPPDATA");
+    if(base && *base) {
+        return (fs::path(base) / "radium" / "shaders").string();
+    }
+#elif defined(__APPLE__)
+    const char *home = std::getenv("HOME");
+    if(home && *home) {
+        return (fs::path(home) / "Library" / "Caches" / "radium" / "shaders").string();
+    }
+#else
+    const char *base = std::getenv("XDG_CACHE_HOME");
+    if(base && *base) {
+        return (fs::path(base) / "radium" / "shaders").string();
+    }
+
+    const char *home = std::getenv("HOME");
+    if(home && *home) {
+        return (fs::path(home) / ".cache" / "radium" / "shaders").string();
+    }
+#endif
+
+    return std::string();
+}
+
+/**
+ * 64 bit FNV-1a, chained through hash
+ */
+static uint64_t fnv1a(uint64_t hash, const void *data, std::size_t size)
+{
+    const uint8_t *bytes = (const uint8_t*)data;
+    for(std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * hashes a string with its size, so the parts of the key can not run
+ * into each other.
+ */
+static uint64_t hash_part(uint64_t hash, const char *data, std::size_t size)
+{
+    const uint64_t length = size;
+    hash = fnv1a(hash, &length, sizeof(length));
+    return fnv1a(hash, data, size);
+}
+
+static uint64_t hash_gl_string(uint64_t hash, GLenum name)
+{
+    const char *value = (const char*)glGetString(name);
+    return value ? hash_part(hash, value, std::strlen(value)) : hash_part(hash, "", 0);
+}
+
+RaProgramCache &RaProgramCache::shared()
+{
+    static RaProgramCache *cache = new RaProgramCache();
+    return *cache;
+}
+
+RaProgramCache::RaProgramCache(): _directory{default_directory()}, _stats{}
+{
+}
+
+bool RaProgramCache::supported()
+{
+    if(_directory.empty() ||
+       !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::get_program_binary>()) {
+        return false;
+    }
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+std::string RaProgramCache::path(
+        std::initializer_list<Corrade::Containers::ArrayView<const char>> sources)
+{
+    uint64_t hash = fnv1a(0xcbf29ce484222325ull, &FileVersion, sizeof(FileVersion));
+
+    for(const Corrade::Containers::ArrayView<const char> &source : sources) {
+        hash = hash_part(hash, source.data(), source.size());
+    }
+
+    hash = hash_gl_string(hash, GL_VENDOR);
+    hash = hash_gl_string(hash, GL_RENDERER);
+    hash = hash_gl_string(hash, GL_VERSION);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+
+    return (fs::path(_directory) / name).string();
+}
+
+bool RaProgramCache::load(GLuint program, const std::string &path)
+{
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if(!file) {
+        return false;
+    }
+
+    uint8_t header[HeaderSize];
+    uint32_t version = 0, format = 0, size = 0;
+    std::vector<char> binary;
+
+    bool ok = std::fread(header, 1, HeaderSize, file) == HeaderSize &&
+              std::memcmp(header, "RAPB", 4) == 0;
+
+    if(ok) {
+        std::memcpy(&version, header + 4, 4);
+        std::memcpy(&format, header + 8, 4);
+        std::memcpy(&size, header + 12, 4);
+
+        ok = version == FileVersion && size > 0 && size <= (64u << 20);
+    }
+
+    if(ok) {
+        binary.resize(size);
+        ok = std::fread(binary.data(), 1, size, file) == size;
+    }
+
+    std::fclose(file);
+
+    if(ok) {
+        glProgramBinary(program, format, binary.data(), (GLsizei)size);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        ok = linked == GL_TRUE;
+    }
+
+    // truncated, or the driver changed without its version string saying so
+    if(!ok) {
+        std::error_code error;
+        fs::remove(path, error);
+        _stats.rejected += 1;
+    }
+
+    return ok;
+}
+
+void RaProgramCache::store(GLuint program, const std::string &path)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLsizei size = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &size, &format, binary.data());
+    if(size <= 0) {
+        return;
+    }
+
+    std::error_code error;
+    fs::create_directories(_directory, error);
+
+    // written next to the binary and renamed, so another process starting
+    // at the same time never reads half a file
+    const std::string temp = path + "." +
+        std::to_string(Clock::now().time_since_epoch().count()) + ".tmp";
+
+    std::FILE *file = std::fopen(temp.c_str(), "wb");
+    if(!file) {
+        return;
+    }
+
+    uint8_t header[HeaderSize];
+    const uint32_t binaryFormat = format, binarySize = (uint32_t)size;
+    std::memcpy(header, "RAPB", 4);
+    std::memcpy(header + 4, &FileVersion, 4);
+    std::memcpy(header + 8, &binaryFormat, 4);
+    std::memcpy(header + 12, &binarySize, 4);
+
+    bool ok = std::fwrite(header, 1, HeaderSize, file) == HeaderSize &&
+              std::fwrite(binary.data(), 1, size, file) == (std::size_t)size;
+    ok = std::fclose(file) == 0 && ok;
+
+    if(ok) {
+        fs::rename(temp, path, error);
+        ok = !error;
+    }
+
+    if(ok) {
+        _stats.stored += 1;
+    }
+    else {
+        fs::remove(temp, error);
+    }
+}
+
+bool RaProgramCache::link(GLuint program,
+        std::initializer_list<Corrade::Containers::ArrayView<const char>> sources,
+        const std::function<bool()> &build)
+{
+    const std::string file = supported() ? path(sources) : std::string();
+
+    if(!file.empty()) {
+        Clock::time_point start = Clock::now();
+        bool loaded = load(program, file);
+        _stats.load_ns += nanoseconds(Clock::now() - start);
+
+        if(loaded) {
+            _stats.hits += 1;
+            return true;
+        }
+
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    Clock::time_point start = Clock::now();
+    bool linked = build();
+    _stats.compile_ns += nanoseconds(Clock::now() - start);
+    _stats.misses += 1;
+
+    if(linked && !file.empty()) {
+        store(program, file);
+    }
+
+    return linked;
+}
+
+HRESULT RaProgramCache::setDirectory(const char *path)
+{
+    if(!path || !*path) {
+        _directory.clear();
+        return S_OK;
+    }
+
+    std::error_code error;
+    fs::create_directories(path, error);
+    if(error) {
+        return c_error(E_FAIL, "could not create the program cache directory");
+    }
+
+    _directory = path;
+    return S_OK;
+}
+
+HRESULT RaProgramCache::clear()
+{
+    if(_directory.empty()) {
+        return S_OK;
+    }
+
+    std::error_code error;
+    for(fs::directory_iterator i{_directory, error}, end; !error && i != end; i.increment(error)) {
+        const fs::path &file = i->path();
+        if(file.extension() == ".bin" || file.extension() == ".tmp") {
+            std::error_code ignored;
+            fs::remove(file, ignored);
+        }
+    }
+
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaProgramCache_SetDirectory(const char *path)
+{
+    return RaProgramCache::shared().setDirectory(path);
+}
+
+CAPI_FUNC(HRESULT) RaProgramCache_Clear()
+{
+    return RaProgramCache::shared().clear();
+}
+
+CAPI_FUNC(HRESULT) RaProgramCache_GetStats(struct RaProgramCacheStats *stats)
+{
+    if(!stats) {
+        return c_error(E_INVALIDARG, "stats is NULL");
+    }
+
+    *stats = RaProgramCache::shared().stats();
+    return S_OK;
+}
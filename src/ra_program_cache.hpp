@@ -0,0 +1,76 @@
+/*
+ * ra_program_cache.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_PROGRAM_CACHE_HPP_
+#define SRC_RA_PROGRAM_CACHE_HPP_
+
+#include <ra_program_cache.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/GL/OpenGL.h>
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+
+/**
+ * The program cache of the process, see ra_program_cache.h.
+ *
+ * Only used from the thread of the GL context, binaries are read and
+ * written there, they are small, and only touched at startup.
+ */
+class RaProgramCache {
+public:
+
+    static RaProgramCache &shared();
+
+    RaProgramCache(const RaProgramCache&) = delete;
+    RaProgramCache& operator=(const RaProgramCache&) = delete;
+
+    /**
+     * Links a program, by loading the binary saved for its sources in the
+     * current context, or by calling build, which compiles and attaches
+     * the shaders and links, and saving the binary if that succeeds.
+     *
+     * @param program id of the program, with nothing attached yet
+     * @param sources the sources of all the shaders, as they are compiled
+     * @returns false if build fails
+     */
+    bool link(GLuint program, std::initializer_list<Corrade::Containers::ArrayView<const char>> sources,
+            const std::function<bool()> &build);
+
+    HRESULT setDirectory(const char *path);
+
+    HRESULT clear();
+
+    const RaProgramCacheStats &stats() const { return _stats; }
+
+private:
+    RaProgramCache();
+
+    /**
+     * binaries can be saved and loaded in the current context
+     */
+    bool supported();
+
+    /**
+     * file of the binary for the sources in the current context
+     */
+    std::string path(std::initializer_list<Corrade::Containers::ArrayView<const char>> sources);
+
+    bool load(GLuint program, const std::string &path);
+
+    void store(GLuint program, const std::string &path);
+
+    /**
+     * empty if disabled
+     */
+    std::string _directory;
+
+    RaProgramCacheStats _stats;
+};
+
+#endif /* SRC_RA_PROGRAM_CACHE_HPP_ */
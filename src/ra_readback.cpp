@@ -0,0 +1,150 @@
+/*
+ * ra_readback.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_readback.hpp"
+#include <ra_upload.h>
+#include <carbon.h>
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Math/Range.h>
+
+#include <cstring>
+
+using namespace Magnum;
+
+static GL::PixelFormat gl_format(uint32_t format)
+{
+    return format == RA_PIXEL_RGBA8 ? GL::PixelFormat::RGBA : GL::PixelFormat::BGRA;
+}
+
+RaReadbackRing::RaReadbackRing(int slots): _next{0}
+{
+    _slots.reserve(slots);
+    for(int i = 0; i < slots; ++i) {
+        _slots.push_back(Slot{
+            GL::BufferImage2D{GL::PixelFormat::BGRA, GL::PixelType::UnsignedByte},
+            RaFence{}, false, RA_PIXEL_BGRA8, nullptr, nullptr, nullptr});
+    }
+}
+
+HRESULT RaReadbackRing::read(GL::AbstractFramebuffer &framebuffer, const RaRect &rect,
+        uint32_t format, void *data, RaFenceCallback callback, void *userData,
+        RaReadStats &stats)
+{
+    // the slot is taken before any callback runs, so a read from within
+    // the callback goes to the next slot instead of this one
+    Slot &slot = _slots[_next];
+    _next = (_next + 1) % (int)_slots.size();
+
+    // every buffer is in flight, the oldest has to be finished first
+    RaFenceCallback stalledCallback = nullptr;
+    void *stalledUserData = nullptr;
+    if(slot.pending) {
+        stats.stalls += 1;
+        slot.fence.wait(UINT64_MAX);
+        finish(slot, stats, stalledCallback, stalledUserData);
+    }
+
+    if(slot.format != format) {
+        slot.image = GL::BufferImage2D{gl_format(format), GL::PixelType::UnsignedByte};
+        slot.format = format;
+    }
+
+    // the buffer is only reallocated when the size changes
+    framebuffer.read({{rect.x, rect.y}, {rect.x + rect.w, rect.y + rect.h}},
+            slot.image, GL::BufferUsage::StreamRead);
+
+    slot.fence.insert();
+    slot.pending = true;
+    slot.data = data;
+    slot.callback = callback;
+    slot.userData = userData;
+
+    // get the fence to the GPU, polling does not flush
+    GL::Renderer::flush();
+
+    stats.reads += 1;
+
+    if(stalledCallback) {
+        stalledCallback(stalledUserData);
+    }
+
+    return S_OK;
+}
+
+int RaReadbackRing::poll(bool wait, RaReadStats &stats)
+{
+    const int count = (int)_slots.size();
+    int pending = 0;
+
+    // the oldest read is in the slot the next read goes to, callbacks may
+    // queue reads and move _next
+    const int oldest = _next;
+    bool blocked = false;
+    for(int i = 0; i < count; ++i) {
+        Slot &slot = _slots[(oldest + i) % count];
+        if(!slot.pending) {
+            continue;
+        }
+
+        if(!blocked && (wait ? slot.fence.wait(UINT64_MAX) : slot.fence.signaled())) {
+            deliver(slot, stats);
+        }
+        else {
+            // later reads wait for this one, so they arrive in order
+            blocked = true;
+            pending += 1;
+        }
+    }
+
+    return pending;
+}
+
+void RaReadbackRing::deliver(Slot &slot, RaReadStats &stats)
+{
+    RaFenceCallback callback;
+    void *userData;
+    finish(slot, stats, callback, userData);
+
+    if(callback) {
+        callback(userData);
+    }
+}
+
+void RaReadbackRing::finish(Slot &slot, RaReadStats &stats, RaFenceCallback &callback,
+        void *&userData)
+{
+    const Vector2i size = slot.image.size();
+    const std::size_t rowSize = (std::size_t)size.x() * 4;
+    const std::size_t total = rowSize * size.y();
+
+    Containers::ArrayView<char> src = slot.image.buffer().map(0, total,
+            GL::Buffer::MapFlag::Read);
+
+    if(src.data()) {
+        // GL rows go bottom up
+        char *dst = static_cast<char*>(slot.data);
+        for(int y = 0; y < size.y(); ++y) {
+            std::memcpy(dst + (std::size_t)(size.y() - 1 - y) * rowSize,
+                    src.data() + y * rowSize, rowSize);
+        }
+        slot.image.buffer().unmap();
+        stats.bytes += total;
+    }
+    else {
+        c_error(E_FAIL, "could not map the read back buffer");
+    }
+
+    slot.pending = false;
+
+    callback = slot.callback;
+    userData = slot.userData;
+    slot.callback = nullptr;
+    slot.data = nullptr;
+}
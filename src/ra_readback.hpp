@@ -0,0 +1,86 @@
+/*
+ * ra_readback.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_READBACK_HPP_
+#define SRC_RA_READBACK_HPP_
+
+#include <ra_window.h>
+#include "ra_damage.hpp"
+#include "ra_fence.hpp"
+#include <Magnum/GL/AbstractFramebuffer.h>
+#include <Magnum/GL/BufferImage.h>
+#include <vector>
+
+/**
+ * Reads framebuffer rects back through a ring of pixel-pack buffers.
+ *
+ * A read only queues the transfer into the next buffer of the ring and
+ * inserts a fence, so it returns without waiting for the GPU. Reads are
+ * delivered in order by poll, once their fence is signaled, usually a
+ * frame or two later: the buffer is mapped, its rows are copied to the
+ * caller's memory top row first, and the callback is called.
+ *
+ * If all the buffers are still in flight, the oldest read is waited on
+ * and delivered first, which shows up as a stall in the stats.
+ */
+class RaReadbackRing {
+public:
+
+    enum { DefaultSlots = 3 };
+
+    explicit RaReadbackRing(int slots);
+
+    int slots() const { return (int)_slots.size(); }
+
+    /**
+     * queues a read of rect, in GL framebuffer coordinates with y up, into
+     * data, in RA_PIXEL_BGRA8 or RA_PIXEL_RGBA8 format.
+     */
+    HRESULT read(Magnum::GL::AbstractFramebuffer &framebuffer, const RaRect &rect,
+            uint32_t format, void *data, RaFenceCallback callback, void *userData,
+            RaReadStats &stats);
+
+    /**
+     * delivers the reads that are done, in the order they were queued, or
+     * all of them if wait is set.
+     *
+     * @returns number of reads still in flight.
+     */
+    int poll(bool wait, RaReadStats &stats);
+
+private:
+    struct Slot {
+        Magnum::GL::BufferImage2D image;
+        RaFence fence;
+        bool pending;
+        uint32_t format;
+        void *data;
+        RaFenceCallback callback;
+        void *userData;
+    };
+
+    /**
+     * finishes the read in slot, and calls its callback.
+     */
+    void deliver(Slot &slot, RaReadStats &stats);
+
+    /**
+     * copies the finished read in slot to the caller's memory and frees the
+     * slot, the callback is returned rather than called, so the caller can
+     * call it once it is done with the slot.
+     */
+    void finish(Slot &slot, RaReadStats &stats, RaFenceCallback &callback, void *&userData);
+
+    std::vector<Slot> _slots;
+
+    /**
+     * slot of the next read, and the oldest read in flight if it is pending
+     */
+    int _next;
+};
+
+#endif /* SRC_RA_READBACK_HPP_ */
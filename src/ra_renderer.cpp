@@ -6,4 +6,15 @@
  */
 
 #include "ra_renderer.hpp"
+#include "ra_gl_registry.hpp"
+#include <carbon.h>
 
+CAPI_FUNC(HRESULT) RaRenderer_GetStats(struct RaRenderStats *stats)
+{
+    if(!stats) {
+        return c_error(E_INVALIDARG, "stats is NULL");
+    }
+
+    *stats = RaGlRegistry::current().state().frameStats();
+    return S_OK;
+}
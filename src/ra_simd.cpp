@@ -0,0 +1,56 @@
+/*
+ * ra_simd.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_simd.hpp"
+
+#include <cstdlib>
+
+#if defined(RA_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static unsigned detect_features()
+{
+    unsigned result = 0;
+
+#if defined(RA_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse2"))   result |= RA_SIMD_SSE2;
+    if(__builtin_cpu_supports("ssse3"))  result |= RA_SIMD_SSSE3;
+    if(__builtin_cpu_supports("sse4.2")) result |= RA_SIMD_SSE42;
+    if(__builtin_cpu_supports("avx2"))   result |= RA_SIMD_AVX2;
+#elif defined(RA_SIMD_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int ids = info[0];
+
+    __cpuid(info, 1);
+    if(info[3] & (1 << 26)) result |= RA_SIMD_SSE2;
+    if(info[2] & (1 << 9))  result |= RA_SIMD_SSSE3;
+    if(info[2] & (1 << 20)) result |= RA_SIMD_SSE42;
+
+    // AVX2 also needs the OS to save the YMM registers
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if(ids >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        if(info[1] & (1 << 5)) result |= RA_SIMD_AVX2;
+    }
+#endif
+
+    const char *mask = std::getenv("RADIUM_SIMD");
+    if(mask) {
+        result &= (unsigned)std::strtoul(mask, NULL, 0);
+    }
+
+    return result;
+}
+
+unsigned RaSimd_Features()
+{
+    static const unsigned features = detect_features();
+    return features;
+}
@@ -0,0 +1,52 @@
+/*
+ * ra_simd.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_SIMD_HPP_
+#define SRC_RA_SIMD_HPP_
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RA_SIMD_X86 1
+#endif
+
+/**
+ * SIMD kernels are compiled for their instruction set with a function
+ * attribute, so the rest of the library keeps the baseline flags, and the
+ * kernel is picked at runtime with RaSimd_Supports. MSVC compiles any
+ * intrinsic without special flags.
+ */
+#if defined(RA_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define RA_TARGET_SSE2   __attribute__((target("sse2")))
+#define RA_TARGET_SSSE3  __attribute__((target("ssse3")))
+#define RA_TARGET_SSE42  __attribute__((target("sse4.2")))
+#define RA_TARGET_AVX2   __attribute__((target("avx2")))
+#else
+#define RA_TARGET_SSE2
+#define RA_TARGET_SSSE3
+#define RA_TARGET_SSE42
+#define RA_TARGET_AVX2
+#endif
+
+enum RaSimdFeature {
+    RA_SIMD_SSE2  = 1 << 0,
+    RA_SIMD_SSSE3 = 1 << 1,
+    RA_SIMD_SSE42 = 1 << 2,
+    RA_SIMD_AVX2  = 1 << 3
+};
+
+/**
+ * bitmask of RaSimdFeature supported by this CPU, detected once.
+ *
+ * The RADIUM_SIMD environment variable, if set, masks the detected
+ * features, i.e. RADIUM_SIMD=0 forces the scalar code paths.
+ */
+unsigned RaSimd_Features();
+
+inline bool RaSimd_Supports(RaSimdFeature feature) {
+    return (RaSimd_Features() & feature) != 0;
+}
+
+#endif /* SRC_RA_SIMD_HPP_ */
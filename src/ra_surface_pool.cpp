@@ -0,0 +1,131 @@
+/*
+ * ra_surface_pool.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_surface_pool.hpp"
+
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/Vector2.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+using namespace Magnum;
+
+RaSurfacePool &RaSurfacePool::shared()
+{
+    static RaSurfacePool *pool = new RaSurfacePool();
+    return *pool;
+}
+
+static int round_up(int size)
+{
+    size = size < 1 ? 1 : size;
+    return (size + RaSurfacePool::Granularity - 1) / RaSurfacePool::Granularity
+        * RaSurfacePool::Granularity;
+}
+
+void RaSurfacePool::storageSize(int width, int height, int &storageWidth, int &storageHeight)
+{
+    storageWidth = round_up(width);
+    storageHeight = round_up(height);
+}
+
+unsigned char *RaSurfacePool::acquirePixels(int storageWidth, int storageHeight)
+{
+    std::size_t size = (std::size_t)storageWidth * 4 * storageHeight;
+
+    std::vector<unsigned char*> &idle = _pixels[{storageWidth, storageHeight}];
+
+    if(idle.empty()) {
+        // fresh pages from calloc are already zero, no need to touch them
+        return (unsigned char*)std::calloc(size, 1);
+    }
+
+    unsigned char *pixels = idle.back();
+    idle.pop_back();
+    std::memset(pixels, 0, size);
+    return pixels;
+}
+
+void RaSurfacePool::releasePixels(unsigned char *pixels, int storageWidth, int storageHeight)
+{
+    if(!pixels) {
+        return;
+    }
+
+    std::vector<unsigned char*> &idle = _pixels[{storageWidth, storageHeight}];
+
+    if(idle.size() < MaxIdle) {
+        idle.push_back(pixels);
+    }
+    else {
+        std::free(pixels);
+    }
+}
+
+GL::Texture2D RaSurfacePool::acquireTexture(int storageWidth, int storageHeight, int levels)
+{
+    std::vector<GL::Texture2D> &idle = _textures[TextureKey{&GL::Context::current(),
+            storageWidth, storageHeight, levels}];
+
+    if(!idle.empty()) {
+        GL::Texture2D texture = std::move(idle.back());
+        idle.pop_back();
+        return texture;
+    }
+
+    GL::Texture2D texture;
+    texture.setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setMagnificationFilter(GL::SamplerFilter::Linear);
+
+    if(levels > 1) {
+        texture.setMinificationFilter(GL::SamplerFilter::Linear, GL::SamplerMipmap::Linear);
+    }
+    else {
+        texture.setMinificationFilter(GL::SamplerFilter::Linear);
+    }
+
+    texture.setStorage(levels, GL::TextureFormat::RGBA8, {storageWidth, storageHeight});
+    return texture;
+}
+
+void RaSurfacePool::releaseTexture(GL::Texture2D &&texture, int storageWidth, int storageHeight,
+        int levels)
+{
+    if(!texture.id()) {
+        return;
+    }
+
+    std::vector<GL::Texture2D> &idle = _textures[TextureKey{&GL::Context::current(),
+            storageWidth, storageHeight, levels}];
+
+    if(idle.size() < MaxIdle) {
+        idle.push_back(std::move(texture));
+    }
+    else {
+        // deletes it
+        GL::Texture2D discard{std::move(texture)};
+    }
+}
+
+void RaSurfacePool::trim()
+{
+    for(auto &i : _pixels) {
+        for(unsigned char *pixels : i.second) {
+            std::free(pixels);
+        }
+    }
+    _pixels.clear();
+
+    // textures of other contexts can only be deleted in those
+    const GL::Context *context = GL::Context::hasCurrent() ? &GL::Context::current() : NULL;
+    for(auto i = _textures.begin(); i != _textures.end();) {
+        i = std::get<0>(i->first) == context ? _textures.erase(i) : std::next(i);
+    }
+}
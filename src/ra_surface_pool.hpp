@@ -0,0 +1,96 @@
+/*
+ * ra_surface_pool.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_SURFACE_POOL_HPP_
+#define SRC_RA_SURFACE_POOL_HPP_
+
+#include <Magnum/GL/Texture.h>
+
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * Pool of surface pixel memory and textures, bucketed by size.
+ *
+ * Sizes are rounded up to a multiple of Granularity, so a canvas that is
+ * resized by a few pixels, or a popup of about the same size as one that
+ * was just destroyed, gets storage from the pool instead of a new malloc
+ * and glTexStorage. Storage is usually larger than the surface using it,
+ * surfaces use a stride of the storage width, and are drawn with a
+ * texture coordinate scale.
+ *
+ * Pixel memory is shared by every context. Textures are pooled per GL
+ * context, like the GL registry, a texture released in one context is
+ * only handed out again in the same one. The texture functions must be
+ * called from the thread of the current context.
+ */
+class RaSurfacePool {
+public:
+
+    enum { Granularity = 128 };
+
+    /**
+     * idle storage kept per bucket, anything released past that is freed.
+     */
+    enum { MaxIdle = 4 };
+
+    /**
+     * the pool shared by all canvases. It is never destroyed, its textures
+     * go away with their contexts.
+     */
+    static RaSurfacePool &shared();
+
+    /**
+     * size of the storage bucket for a surface of the given size.
+     */
+    static void storageSize(int width, int height, int &storageWidth, int &storageHeight);
+
+    /**
+     * cleared ARGB32 pixels for a bucket, rows are storageWidth * 4 bytes.
+     */
+    unsigned char *acquirePixels(int storageWidth, int storageHeight);
+
+    void releasePixels(unsigned char *pixels, int storageWidth, int storageHeight);
+
+    /**
+     * RGBA8 texture of the current context with immutable storage of the
+     * bucket size, and the given number of mip levels, mipmapped textures
+     * filter with trilinear minification.
+     */
+    Magnum::GL::Texture2D acquireTexture(int storageWidth, int storageHeight, int levels = 1);
+
+    /**
+     * keeps the texture for the current context, which must be the one
+     * it was created in.
+     */
+    void releaseTexture(Magnum::GL::Texture2D &&texture, int storageWidth, int storageHeight,
+            int levels = 1);
+
+    /**
+     * frees all the idle pixel memory, and the idle textures of the
+     * current context.
+     */
+    void trim();
+
+private:
+    RaSurfacePool() = default;
+
+    /**
+     * idle pixels by bucket size
+     */
+    std::map<std::pair<int, int>, std::vector<unsigned char*>> _pixels;
+
+    /**
+     * idle textures by context, bucket size and mip level count
+     */
+    typedef std::tuple<const Magnum::GL::Context*, int, int, int> TextureKey;
+    std::map<TextureKey, std::vector<Magnum::GL::Texture2D>> _textures;
+};
+
+#endif /* SRC_RA_SURFACE_POOL_HPP_ */
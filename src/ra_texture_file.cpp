@@ -0,0 +1,199 @@
+/*
+ * ra_texture_file.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_texture_file.hpp"
+#include "ra_mipmap.hpp"
+#include <ra_upload.h>
+#include <carbon.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+static const std::size_t HeaderSize = 32;
+static const std::size_t LevelEntrySize = 16;
+static const std::size_t LevelAlignment = 4096;
+
+static uint32_t get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t get64(const uint8_t *p)
+{
+    return (uint64_t)get32(p) | (uint64_t)get32(p + 4) << 32;
+}
+
+static void put32(std::vector<uint8_t> &buf, uint32_t value)
+{
+    for(int i = 0; i < 4; ++i) {
+        buf.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void put64(std::vector<uint8_t> &buf, uint64_t value)
+{
+    put32(buf, (uint32_t)value);
+    put32(buf, (uint32_t)(value >> 32));
+}
+
+bool RaTextureFile_Is(const void *data, std::size_t size)
+{
+    return size >= 4 && std::memcmp(data, "RTEX", 4) == 0;
+}
+
+HRESULT RaTextureFile_Parse(const void *data, std::size_t size, RaTextureFile &file)
+{
+    const uint8_t *bytes = (const uint8_t*)data;
+
+    if(size < HeaderSize || !RaTextureFile_Is(data, size)) {
+        return c_error(E_INVALIDARG, "not a texture file");
+    }
+
+    if(get32(bytes + 4) != RaTextureFile_Version) {
+        return c_error(E_INVALIDARG, "unsupported texture file version");
+    }
+
+    const uint32_t format = get32(bytes + 8);
+    const uint32_t width = get32(bytes + 12);
+    const uint32_t height = get32(bytes + 16);
+    const uint32_t levels = get32(bytes + 20);
+
+    if(format != RA_PIXEL_BGRA8 && format != RA_PIXEL_RGBA8) {
+        return c_error(E_INVALIDARG, "unsupported texture file pixel format");
+    }
+
+    if(width == 0 || height == 0 || width > 0xffff || height > 0xffff || levels == 0 ||
+       levels > (uint32_t)RaMipmap_LevelCount(width, height)) {
+        return c_error(E_INVALIDARG, "invalid texture file size");
+    }
+
+    if(size < HeaderSize + levels * LevelEntrySize) {
+        return c_error(E_INVALIDARG, "truncated texture file");
+    }
+
+    file.format = format;
+    file.width = width;
+    file.height = height;
+    file.levels.clear();
+
+    for(uint32_t l = 0; l < levels; ++l) {
+        const uint8_t *entry = bytes + HeaderSize + l * LevelEntrySize;
+        const uint64_t offset = get64(entry);
+        const uint32_t w = get32(entry + 8);
+        const uint32_t h = get32(entry + 12);
+
+        if(w != std::max(1u, width >> l) || h != std::max(1u, height >> l)) {
+            return c_error(E_INVALIDARG, "invalid texture file level size");
+        }
+
+        // the writer aligns every level past the level table, the pages
+        // of a mapped file are then handed to GL as they are
+        if(offset % LevelAlignment != 0 || offset < HeaderSize + levels * LevelEntrySize) {
+            return c_error(E_INVALIDARG, "misaligned texture file level");
+        }
+
+        if(offset > size || (uint64_t)w * h * 4 > size - offset) {
+            return c_error(E_INVALIDARG, "truncated texture file");
+        }
+
+        file.levels.push_back({bytes + offset, (int)w, (int)h});
+    }
+
+    return S_OK;
+}
+
+HRESULT RaTextureFile_Write(const char *path, uint32_t format, int width, int height,
+        const uint8_t *rgba, int stride, bool mipmaps)
+{
+    if(!path || !rgba || width <= 0 || height <= 0 || width > 0xffff || height > 0xffff) {
+        return c_error(E_INVALIDARG, "invalid texture file path or size");
+    }
+
+    if(format != RA_PIXEL_BGRA8 && format != RA_PIXEL_RGBA8) {
+        return c_error(E_INVALIDARG, "texture files are BGRA8 or RGBA8");
+    }
+
+    if(stride == 0) {
+        stride = width * 4;
+    }
+
+    // level 0 in the stored layout
+    const std::size_t rowSize = (std::size_t)width * 4;
+    std::vector<uint8_t> level0(rowSize * height);
+
+    for(int y = 0; y < height; ++y) {
+        uint8_t *dst = level0.data() + y * rowSize;
+        std::memcpy(dst, rgba + (std::size_t)y * stride, rowSize);
+        if(format == RA_PIXEL_BGRA8) {
+            for(int x = 0; x < width; ++x) {
+                std::swap(dst[4 * x], dst[4 * x + 2]);
+            }
+        }
+    }
+
+    // the box filter treats all 4 channels alike, so filters either order
+    std::unique_ptr<RaMipChain> chain;
+    if(mipmaps) {
+        chain.reset(new RaMipChain(width, height));
+        chain->build(level0.data(), (int)rowSize);
+    }
+
+    const int levels = chain ? chain->levels() : 1;
+
+    std::vector<uint8_t> header;
+    header.insert(header.end(), {'R', 'T', 'E', 'X'});
+    put32(header, RaTextureFile_Version);
+    put32(header, format);
+    put32(header, width);
+    put32(header, height);
+    put32(header, levels);
+    put64(header, 0);
+
+    uint64_t offset = HeaderSize + levels * LevelEntrySize;
+    for(int l = 0; l < levels; ++l) {
+        const int w = chain ? chain->levelWidth(l) : width;
+        const int h = chain ? chain->levelHeight(l) : height;
+
+        offset = (offset + LevelAlignment - 1) / LevelAlignment * LevelAlignment;
+        put64(header, offset);
+        put32(header, w);
+        put32(header, h);
+        offset += (uint64_t)w * h * 4;
+    }
+
+    std::FILE *file = std::fopen(path, "wb");
+    if(!file) {
+        return c_error(E_FAIL, "could not create texture file");
+    }
+
+    bool ok = std::fwrite(header.data(), 1, header.size(), file) == header.size();
+    uint64_t written = header.size();
+
+    static const uint8_t zeros[LevelAlignment] = {};
+
+    for(int l = 0; ok && l < levels; ++l) {
+        const uint8_t *pixels = l ? chain->levelData(l) : level0.data();
+        const std::size_t size = (std::size_t)(l ? chain->levelWidth(l) * chain->levelHeight(l)
+                                                 : width * height) * 4;
+
+        const std::size_t pad = (std::size_t)((LevelAlignment - written % LevelAlignment) %
+                                              LevelAlignment);
+
+        ok = std::fwrite(zeros, 1, pad, file) == pad &&
+             std::fwrite(pixels, 1, size, file) == size;
+        written += pad + size;
+    }
+
+    ok = std::fclose(file) == 0 && ok;
+
+    if(!ok) {
+        return c_error(E_FAIL, "could not write texture file");
+    }
+    return S_OK;
+}
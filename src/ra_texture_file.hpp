@@ -0,0 +1,71 @@
+/*
+ * ra_texture_file.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_TEXTURE_FILE_HPP_
+#define SRC_RA_TEXTURE_FILE_HPP_
+
+#include <c_port.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Radium texture files, .rtex, images stored the way they are uploaded,
+ * so they are mapped and handed to GL with no decoding and no copy.
+ *
+ * Layout, all little endian:
+ *
+ *     header       "RTEX", version, format, width, height, levels, and
+ *                  8 reserved bytes, 32 bytes in all
+ *     level table  for each level, uint64 offset, uint32 width and height
+ *     level data   tightly packed 4 byte pixels, rows top down, in the
+ *                  RaPixelFormat of the header, BGRA8 or RGBA8, each level
+ *                  at a 4096 byte aligned offset
+ *
+ * Level sizes halve and round down, as GL mip levels do. Files are written
+ * by the ra-texconv tool, and load like any other image with RaAsset_Load,
+ * from a file or the compiled in resources.
+ */
+static const uint32_t RaTextureFile_Version = 1;
+
+struct RaTextureLevel {
+    const uint8_t *data;
+    int width;
+    int height;
+};
+
+struct RaTextureFile {
+    uint32_t format;
+    int width;
+    int height;
+
+    /**
+     * level 0, then the mip levels, pointing into the parsed data
+     */
+    std::vector<RaTextureLevel> levels;
+};
+
+/**
+ * checks the magic at the start of data.
+ */
+bool RaTextureFile_Is(const void *data, std::size_t size);
+
+/**
+ * checks the header and level table, and points the levels into data,
+ * which must outlive them.
+ */
+HRESULT RaTextureFile_Parse(const void *data, std::size_t size, RaTextureFile &file);
+
+/**
+ * writes a texture file of width x height RGBA8 pixels, rows stride bytes
+ * apart, swizzled to format, with a full mip chain if mipmaps is set.
+ */
+HRESULT RaTextureFile_Write(const char *path, uint32_t format, int width, int height,
+        const uint8_t *rgba, int stride, bool mipmaps);
+
+#endif /* SRC_RA_TEXTURE_FILE_HPP_ */
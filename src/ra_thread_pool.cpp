@@ -0,0 +1,124 @@
+/*
+ * ra_thread_pool.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+RaThreadPool::RaThreadPool(int threads): _stop{false}
+{
+    if(threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for(int i = 0; i < threads; ++i) {
+        _workers.emplace_back(&RaThreadPool::run, this);
+    }
+}
+
+RaThreadPool::~RaThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cond.notify_all();
+
+    for(std::thread &t : _workers) {
+        t.join();
+    }
+}
+
+void RaThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+    _cond.notify_one();
+}
+
+void RaThreadPool::run()
+{
+    for(;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait(lock, [this] { return _stop || !_tasks.empty(); });
+
+            if(_tasks.empty()) {
+                return;
+            }
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
+
+namespace {
+
+/**
+ * shared between the caller and the helpers of a parallelFor, helpers can
+ * start after the caller has returned, so they keep it alive.
+ */
+struct ParallelFor {
+    std::function<void(int)> fn;
+    int count;
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    void work() {
+        int i;
+        while((i = next.fetch_add(1)) < count) {
+            fn(i);
+            if(done.fetch_add(1) + 1 == count) {
+                std::lock_guard<std::mutex> lock(mutex);
+                cond.notify_all();
+            }
+        }
+    }
+};
+
+}
+
+void RaThreadPool::parallelFor(int count, const std::function<void(int)> &fn)
+{
+    if(count <= 0) {
+        return;
+    }
+
+    if(count == 1) {
+        fn(0);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelFor>();
+    state->fn = fn;
+    state->count = count;
+
+    int helpers = std::min(count - 1, threads());
+    for(int i = 0; i < helpers; ++i) {
+        submit([state] { state->work(); });
+    }
+
+    state->work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cond.wait(lock, [&state] { return state->done.load() == state->count; });
+}
+
+RaThreadPool &RaThreadPool::shared()
+{
+    static RaThreadPool pool;
+    return pool;
+}
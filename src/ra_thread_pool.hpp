@@ -0,0 +1,68 @@
+/*
+ * ra_thread_pool.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_THREAD_POOL_HPP_
+#define SRC_RA_THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads running queued tasks in order.
+ */
+class RaThreadPool {
+public:
+
+    /**
+     * starts the workers, threads <= 0 uses one per hardware thread.
+     */
+    explicit RaThreadPool(int threads = 0);
+
+    /**
+     * finishes the queued tasks and joins the workers.
+     */
+    ~RaThreadPool();
+
+    RaThreadPool(const RaThreadPool&) = delete;
+    RaThreadPool& operator=(const RaThreadPool&) = delete;
+
+    /**
+     * queues a task to run on one of the workers.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * Runs fn(i) for each i in [0, count) spread over the workers and the
+     * calling thread, and returns once all of them are done.
+     *
+     * The calling thread takes part, so this makes progress even if all
+     * the workers are busy with other tasks.
+     */
+    void parallelFor(int count, const std::function<void(int)> &fn);
+
+    int threads() const { return (int)_workers.size(); }
+
+    /**
+     * process wide pool, created on first use.
+     */
+    static RaThreadPool &shared();
+
+private:
+    void run();
+
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    bool _stop;
+};
+
+#endif /* SRC_RA_THREAD_POOL_HPP_ */
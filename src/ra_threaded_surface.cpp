@@ -0,0 +1,47 @@
+/*
+ * ra_threaded_surface.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_threaded_surface.hpp"
+#include "ra_surface_pool.hpp"
+
+RaThreadedSurface::RaThreadedSurface(int width, int height, int storageWidth, int storageHeight):
+    _storageWidth{storageWidth}, _storageHeight{storageHeight}
+{
+    RaSurfacePool &pool = RaSurfacePool::shared();
+
+    for(Buffer &b : _buffers) {
+        b.pixels = pool.acquirePixels(storageWidth, storageHeight);
+        b.surface = cairo_image_surface_create_for_data(b.pixels, CAIRO_FORMAT_ARGB32,
+                width, height, storageWidth * 4);
+        b.cr = cairo_create(b.surface);
+    }
+}
+
+RaThreadedSurface::~RaThreadedSurface()
+{
+    RaSurfacePool &pool = RaSurfacePool::shared();
+
+    for(Buffer &b : _buffers) {
+        cairo_destroy(b.cr);
+        cairo_surface_destroy(b.surface);
+        pool.releasePixels(b.pixels, _storageWidth, _storageHeight);
+    }
+}
+
+void RaThreadedSurface::publish()
+{
+    cairo_surface_flush(surface());
+    _frames.publish();
+}
+
+cairo_surface_t *RaThreadedSurface::consume()
+{
+    if(!_frames.consume()) {
+        return nullptr;
+    }
+    return _buffers[_frames.front()].surface;
+}
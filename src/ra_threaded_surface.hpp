@@ -0,0 +1,75 @@
+/*
+ * ra_threaded_surface.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_THREADED_SURFACE_HPP_
+#define SRC_RA_THREADED_SURFACE_HPP_
+
+#include <cairo.h>
+#include "ra_triple_buffer.hpp"
+
+/**
+ * Three cairo image surfaces, drawn by a producer thread and uploaded by
+ * the GL thread, handed over through a RaTripleBuffer.
+ *
+ * The producer draws a frame into its surface and publishes it, the GL
+ * thread picks up the latest published frame when it draws. Like a swap
+ * chain, the producer surface after publishing holds an older frame, so
+ * every frame has to be completely redrawn.
+ *
+ * The pixel memory comes from the surface pool, so the surfaces must be
+ * created and destroyed on the GL thread, with the producer stopped.
+ */
+class RaThreadedSurface {
+public:
+
+    RaThreadedSurface(int width, int height, int storageWidth, int storageHeight);
+
+    ~RaThreadedSurface();
+
+    RaThreadedSurface(const RaThreadedSurface&) = delete;
+    RaThreadedSurface& operator=(const RaThreadedSurface&) = delete;
+
+    /**
+     * surface and cairo object of the producer, change after each publish.
+     */
+    cairo_surface_t *surface() const { return _buffers[_frames.back()].surface; }
+
+    cairo_t *cr() const { return _buffers[_frames.back()].cr; }
+
+    /**
+     * flushes the producer surface, and makes it the latest frame.
+     */
+    void publish();
+
+    /**
+     * on the GL thread, takes the latest frame if one was published since
+     * the last call.
+     *
+     * @returns the surface of the new frame, or NULL if there is none.
+     */
+    cairo_surface_t *consume();
+
+    /**
+     * on the GL thread, the surface of the frame last consumed, the one
+     * on screen.
+     */
+    cairo_surface_t *front() const { return _buffers[_frames.front()].surface; }
+
+private:
+    struct Buffer {
+        unsigned char *pixels;
+        cairo_surface_t *surface;
+        cairo_t *cr;
+    };
+
+    Buffer _buffers[3];
+    RaTripleBuffer _frames;
+    int _storageWidth;
+    int _storageHeight;
+};
+
+#endif /* SRC_RA_THREADED_SURFACE_HPP_ */
@@ -0,0 +1,278 @@
+/*
+ * ra_tile_hash.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_tile_hash.hpp"
+#include "ra_simd.hpp"
+#include "ra_thread_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef RA_SIMD_X86
+#include <immintrin.h>
+#endif
+
+enum { Unchanged = 1, Changed = 2 };
+
+/**
+ * byte at a time table for the reflected CRC32C polynomial, the same
+ * polynomial as the SSE4.2 crc32 instruction.
+ */
+static const uint32_t *crc32c_table()
+{
+    static uint32_t table[256];
+    static bool init = [] {
+        for(uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for(int k = 0; k < 8; ++k) {
+                c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1)));
+            }
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)init;
+    return table;
+}
+
+static inline uint32_t crc32c_bytes(const uint32_t *table, uint32_t crc,
+        const uint8_t *p, int n)
+{
+    for(int i = 0; i < n; ++i) {
+        crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static uint64_t hash_scalar(const uint8_t *data, std::size_t stride, int rowBytes, int rows)
+{
+    const uint32_t *table = crc32c_table();
+    uint32_t a = 0xffffffffu;
+    uint32_t b = 0xffffffffu;
+
+    for(int y = 0; y < rows; ++y) {
+        const uint8_t *p = data + y * stride;
+        int i = 0;
+        for(; i + 16 <= rowBytes; i += 16) {
+            a = crc32c_bytes(table, a, p + i, 8);
+            b = crc32c_bytes(table, b, p + i + 8, 8);
+        }
+        if(i + 8 <= rowBytes) {
+            a = crc32c_bytes(table, a, p + i, 8);
+            i += 8;
+        }
+        if(i < rowBytes) {
+            b = crc32c_bytes(table, b, p + i, 4);
+        }
+    }
+
+    return ((uint64_t)a << 32) | b;
+}
+
+#ifdef RA_SIMD_X86
+
+RA_TARGET_SSE42 static uint64_t hash_sse42(const uint8_t *data, std::size_t stride,
+        int rowBytes, int rows)
+{
+    // two accumulators hide the latency of the crc32 instruction, and give
+    // 64 bits of hash
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t a = 0xffffffffu;
+    uint64_t b = 0xffffffffu;
+
+    for(int y = 0; y < rows; ++y) {
+        const uint8_t *p = data + y * stride;
+        int i = 0;
+        for(; i + 16 <= rowBytes; i += 16) {
+            uint64_t u, v;
+            std::memcpy(&u, p + i, 8);
+            std::memcpy(&v, p + i + 8, 8);
+            a = _mm_crc32_u64(a, u);
+            b = _mm_crc32_u64(b, v);
+        }
+        if(i + 8 <= rowBytes) {
+            uint64_t u;
+            std::memcpy(&u, p + i, 8);
+            a = _mm_crc32_u64(a, u);
+            i += 8;
+        }
+        if(i < rowBytes) {
+            uint32_t v;
+            std::memcpy(&v, p + i, 4);
+            b = _mm_crc32_u32((uint32_t)b, v);
+        }
+    }
+
+    return (a << 32) | (uint32_t)b;
+#else
+    uint32_t a = 0xffffffffu;
+    uint32_t b = 0xffffffffu;
+
+    for(int y = 0; y < rows; ++y) {
+        const uint8_t *p = data + y * stride;
+        int i = 0;
+        for(; i + 16 <= rowBytes; i += 16) {
+            uint32_t u[4];
+            std::memcpy(u, p + i, 16);
+            a = _mm_crc32_u32(_mm_crc32_u32(a, u[0]), u[1]);
+            b = _mm_crc32_u32(_mm_crc32_u32(b, u[2]), u[3]);
+        }
+        if(i + 8 <= rowBytes) {
+            uint32_t u[2];
+            std::memcpy(u, p + i, 8);
+            a = _mm_crc32_u32(_mm_crc32_u32(a, u[0]), u[1]);
+            i += 8;
+        }
+        if(i < rowBytes) {
+            uint32_t v;
+            std::memcpy(&v, p + i, 4);
+            b = _mm_crc32_u32(b, v);
+        }
+    }
+
+    return ((uint64_t)a << 32) | b;
+#endif
+}
+
+#endif
+
+RaTileHasher RaTileHash_HasherScalar()
+{
+    return hash_scalar;
+}
+
+RaTileHasher RaTileHash_Hasher()
+{
+#ifdef RA_SIMD_X86
+    if(RaSimd_Supports(RA_SIMD_SSE42)) {
+        return hash_sse42;
+    }
+#endif
+    return hash_scalar;
+}
+
+RaTileHashes::RaTileHashes(int width, int height, int tileSize):
+    _width{width}, _height{height}, _tileSize{std::max(8, tileSize)},
+    _hasher{RaTileHash_Hasher()}
+{
+    _columns = (_width + _tileSize - 1) / _tileSize;
+    _rows = (_height + _tileSize - 1) / _tileSize;
+
+    std::size_t tiles = (std::size_t)_columns * _rows;
+    _hashes.assign(tiles, 0);
+    _valid.assign(tiles, 0);
+    _state.assign(tiles, 0);
+}
+
+void RaTileHashes::invalidate()
+{
+    std::fill(_valid.begin(), _valid.end(), 0);
+}
+
+void RaTileHashes::diff(const RaPixelSource &src, const RaRect *rects, int count,
+        std::vector<RaRect> &changed, uint64_t &skipped)
+{
+    changed.clear();
+
+    if(_columns == 0 || _rows == 0) {
+        return;
+    }
+
+    std::fill(_state.begin(), _state.end(), 0);
+
+    // tiles under any of the rects
+    int rowMin = _rows, rowMax = -1;
+    for(int i = 0; i < count; ++i) {
+        const RaRect &r = rects[i];
+        int x0 = std::max(0, r.x), y0 = std::max(0, r.y);
+        int x1 = std::min(_width, r.x + r.w), y1 = std::min(_height, r.y + r.h);
+        if(x0 >= x1 || y0 >= y1) {
+            continue;
+        }
+
+        int c0 = x0 / _tileSize, c1 = (x1 - 1) / _tileSize;
+        int r0 = y0 / _tileSize, r1 = (y1 - 1) / _tileSize;
+        for(int row = r0; row <= r1; ++row) {
+            std::memset(&_state[(std::size_t)row * _columns + c0], Unchanged, c1 - c0 + 1);
+        }
+        rowMin = std::min(rowMin, r0);
+        rowMax = std::max(rowMax, r1);
+    }
+
+    if(rowMax < rowMin) {
+        return;
+    }
+
+    const uint8_t *data = (const uint8_t*)src.data;
+    std::size_t stride = (std::size_t)src.row_length * src.pixel_size;
+
+    // each tile row only touches its own hashes and states
+    RaThreadPool::shared().parallelFor(rowMax - rowMin + 1, [&](int i) {
+        int row = rowMin + i;
+        int y = row * _tileSize;
+        int h = std::min(_tileSize, _height - y);
+
+        for(int col = 0; col < _columns; ++col) {
+            std::size_t t = (std::size_t)row * _columns + col;
+            if(!_state[t]) {
+                continue;
+            }
+
+            int x = col * _tileSize;
+            int w = std::min(_tileSize, _width - x);
+
+            uint64_t hash = _hasher(data + y * stride + (std::size_t)x * src.pixel_size,
+                    stride, w * src.pixel_size, h);
+
+            if(!_valid[t] || _hashes[t] != hash) {
+                _hashes[t] = hash;
+                _valid[t] = 1;
+                _state[t] = Changed;
+            }
+        }
+    });
+
+    // runs of changed tiles in a row become one rect, which grows down
+    // while the rows below have a run with the same span
+    for(int row = rowMin; row <= rowMax; ++row) {
+        int y = row * _tileSize;
+        int h = std::min(_tileSize, _height - y);
+
+        for(int col = 0; col < _columns;) {
+            uint8_t s = _state[(std::size_t)row * _columns + col];
+            if(s != Changed) {
+                if(s == Unchanged) {
+                    int x = col * _tileSize;
+                    skipped += (uint64_t)std::min(_tileSize, _width - x) * h * src.pixel_size;
+                }
+                col += 1;
+                continue;
+            }
+
+            int start = col;
+            while(col < _columns && _state[(std::size_t)row * _columns + col] == Changed) {
+                col += 1;
+            }
+
+            RaRect run = {start * _tileSize, y,
+                std::min(col * _tileSize, _width) - start * _tileSize, h};
+
+            bool merged = false;
+            for(RaRect &r : changed) {
+                if(r.x == run.x && r.w == run.w && r.y + r.h == run.y) {
+                    r.h += run.h;
+                    merged = true;
+                    break;
+                }
+            }
+
+            if(!merged) {
+                changed.push_back(run);
+            }
+        }
+    }
+}
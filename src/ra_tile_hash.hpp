@@ -0,0 +1,86 @@
+/*
+ * ra_tile_hash.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_TILE_HASH_HPP_
+#define SRC_RA_TILE_HASH_HPP_
+
+#include "ra_damage.hpp"
+#include "ra_upload.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * hashes rows rows of rowBytes bytes each, stride bytes apart. rowBytes
+ * is a multiple of 4.
+ */
+typedef uint64_t (*RaTileHasher)(const uint8_t *data, std::size_t stride,
+        int rowBytes, int rows);
+
+/**
+ * the fastest tile hasher for this CPU, SSE4.2 CRC32C or scalar. Both give
+ * the same hash for the same data.
+ */
+RaTileHasher RaTileHash_Hasher();
+
+/**
+ * the table driven hasher, for testing and comparison with the SIMD path.
+ */
+RaTileHasher RaTileHash_HasherScalar();
+
+/**
+ * Finds the tiles of a surface whose content changed since the last frame.
+ *
+ * The surface is split into square tiles, and each tile is hashed with
+ * CRC32C, computed on alternating 8 byte words with two independent
+ * accumulators, so a 64 bit hash. The hashes are kept between frames, a
+ * tile is changed if its hash is different. Nothing is known about the
+ * first frame, every tile is changed.
+ */
+class RaTileHashes {
+public:
+
+    enum { DefaultTileSize = 64 };
+
+    RaTileHashes(int width, int height, int tileSize = DefaultTileSize);
+
+    int tileSize() const { return _tileSize; }
+
+    /**
+     * Hashes the tiles under rects, and gets the parts of the surface
+     * that changed as a short list of rects, in whole tiles clipped to the
+     * surface.
+     *
+     * @param skipped incremented by the size in bytes of the tiles under
+     * rects that are unchanged.
+     */
+    void diff(const RaPixelSource &src, const RaRect *rects, int count,
+            std::vector<RaRect> &changed, uint64_t &skipped);
+
+    /**
+     * forgets all the hashes, every tile is changed on the next diff.
+     */
+    void invalidate();
+
+private:
+    int _width;
+    int _height;
+    int _tileSize;
+    int _columns;
+    int _rows;
+    RaTileHasher _hasher;
+
+    std::vector<uint64_t> _hashes;
+    std::vector<uint8_t> _valid;
+
+    /**
+     * per frame state, 0 for tiles not under a rect, Unchanged or Changed
+     */
+    std::vector<uint8_t> _state;
+};
+
+#endif /* SRC_RA_TILE_HASH_HPP_ */
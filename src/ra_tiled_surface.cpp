@@ -0,0 +1,129 @@
+/*
+ * ra_tiled_surface.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_tiled_surface.hpp"
+#include "ra_thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+RaTiledSurface::RaTiledSurface(int width, int height, int tileSize):
+    _recording{nullptr}, _cr{nullptr}, _width{width}, _height{height},
+    _tileSize{tileSize}
+{
+    newRecording();
+}
+
+RaTiledSurface::~RaTiledSurface()
+{
+    cairo_destroy(_cr);
+    cairo_surface_destroy(_recording);
+}
+
+void RaTiledSurface::newRecording()
+{
+    if(_cr) {
+        cairo_destroy(_cr);
+    }
+
+    if(_recording) {
+        cairo_surface_destroy(_recording);
+    }
+
+    cairo_rectangle_t extents = {0, 0, (double)_width, (double)_height};
+    _recording = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+    _cr = cairo_create(_recording);
+}
+
+/**
+ * replays the recording into the tile of the target pixels, through an
+ * image surface of its own over the tile's rows, so no two threads ever
+ * draw through the same cairo surface.
+ */
+static void replay_tile(cairo_surface_t *recording, unsigned char *pixels, int stride,
+        const RaRect &tile)
+{
+    cairo_surface_t *sub = cairo_image_surface_create_for_data(
+            pixels + (std::size_t)tile.y * stride + (std::size_t)tile.x * 4,
+            CAIRO_FORMAT_ARGB32, tile.w, tile.h, stride);
+
+    cairo_t *cr = cairo_create(sub);
+    cairo_set_source_surface(cr, recording, -tile.x, -tile.y);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    cairo_surface_destroy(sub);
+}
+
+RaRect RaTiledSurface::rasterize(cairo_surface_t *target)
+{
+    cairo_surface_flush(_recording);
+
+    double ix, iy, iw, ih;
+    cairo_recording_surface_ink_extents(_recording, &ix, &iy, &iw, &ih);
+
+    int x0 = std::max(0, (int)std::floor(ix));
+    int y0 = std::max(0, (int)std::floor(iy));
+    int x1 = std::min(_width, (int)std::ceil(ix + iw));
+    int y1 = std::min(_height, (int)std::ceil(iy + ih));
+
+    RaRect ink = {x0, y0, x1 - x0, y1 - y0};
+
+    if(ink.empty()) {
+        newRecording();
+        return {0, 0, 0, 0};
+    }
+
+    // only the tiles the recording touches
+    std::vector<RaRect> tiles;
+    for(int ty = y0 / _tileSize * _tileSize; ty < y1; ty += _tileSize) {
+        for(int tx = x0 / _tileSize * _tileSize; tx < x1; tx += _tileSize) {
+            tiles.push_back({tx, ty,
+                std::min(_tileSize, _width - tx),
+                std::min(_tileSize, _height - ty)});
+        }
+    }
+
+    cairo_surface_flush(target);
+    unsigned char *pixels = cairo_image_surface_get_data(target);
+    const int stride = cairo_image_surface_get_stride(target);
+
+    // Painting a surface attaches snapshots to it, so a recording can not
+    // be a source on several threads at once. Each group of tiles gets
+    // its own copy, made here, and flushing the recording after each
+    // copy detaches the snapshot the copy took, so no two copies share
+    // anything.
+    const int groups = std::min((int)tiles.size(), RaThreadPool::shared().threads() + 1);
+    std::vector<cairo_surface_t*> copies(groups);
+
+    cairo_rectangle_t extents = {0, 0, (double)_width, (double)_height};
+    for(cairo_surface_t *&copy : copies) {
+        copy = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+        cairo_t *cr = cairo_create(copy);
+        cairo_set_source_surface(cr, _recording, 0, 0);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+        cairo_surface_flush(_recording);
+    }
+
+    RaThreadPool::shared().parallelFor(groups, [&](int group) {
+        for(int i = group; i < (int)tiles.size(); i += groups) {
+            replay_tile(copies[group], pixels, stride, tiles[i]);
+        }
+    });
+
+    for(cairo_surface_t *copy : copies) {
+        cairo_surface_destroy(copy);
+    }
+
+    cairo_surface_mark_dirty_rectangle(target, ink.x, ink.y, ink.w, ink.h);
+
+    newRecording();
+
+    return ink;
+}
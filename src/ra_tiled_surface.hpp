@@ -0,0 +1,66 @@
+/*
+ * ra_tiled_surface.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_TILED_SURFACE_HPP_
+#define SRC_RA_TILED_SURFACE_HPP_
+
+#include <cairo.h>
+#include "ra_damage.hpp"
+
+/**
+ * Records a frame's drawing commands, and rasterizes them in parallel, tile
+ * by tile, into an image surface.
+ *
+ * Drawing goes to a cairo recording surface. On flush, the target image
+ * surface is split into tiles, and the tiles that the recording touches
+ * are replayed on the shared thread pool, each thread from its own copy
+ * of the recording, into an image surface of its own over the tile's
+ * pixels. The recording is then replaced by an empty one.
+ *
+ * The recording is painted over the image, so a frame is composited on
+ * top of the previous one as a whole: operators other than OVER, i.e.
+ * CLEAR or SOURCE, only act on what the same frame drew, never on the
+ * pixels already in the image.
+ */
+class RaTiledSurface {
+public:
+
+    enum { DefaultTileSize = 256 };
+
+    RaTiledSurface(int width, int height, int tileSize = DefaultTileSize);
+
+    ~RaTiledSurface();
+
+    RaTiledSurface(const RaTiledSurface&) = delete;
+    RaTiledSurface& operator=(const RaTiledSurface&) = delete;
+
+    /**
+     * cairo object for the recording of the current frame. It is
+     * destroyed by rasterize, and replaced by one for the next frame.
+     */
+    cairo_t *cr() const { return _cr; }
+
+    /**
+     * Replays the recorded frame into target, an ARGB32 image surface,
+     * and starts a new recording.
+     *
+     * @returns the area of the target touched by the replay, empty if
+     * nothing was drawn.
+     */
+    RaRect rasterize(cairo_surface_t *target);
+
+private:
+    void newRecording();
+
+    cairo_surface_t *_recording;
+    cairo_t *_cr;
+    int _width;
+    int _height;
+    int _tileSize;
+};
+
+#endif /* SRC_RA_TILED_SURFACE_HPP_ */
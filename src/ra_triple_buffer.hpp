@@ -0,0 +1,71 @@
+/*
+ * ra_triple_buffer.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_TRIPLE_BUFFER_HPP_
+#define SRC_RA_TRIPLE_BUFFER_HPP_
+
+#include <atomic>
+
+/**
+ * Lock-free handoff of three buffers between one producer and one
+ * consumer thread.
+ *
+ * The producer owns the back buffer and the consumer the front buffer.
+ * The third buffer sits in between, in an atomic index, with a flag set
+ * when it holds a frame the consumer has not seen. Publishing swaps the
+ * back buffer into the middle, consuming swaps the middle into the front,
+ * so neither side ever waits for the other, and the consumer always gets
+ * the most recent complete frame, skipping any it was too slow for.
+ */
+class RaTripleBuffer {
+public:
+
+    RaTripleBuffer(): _middle{1}, _back{0}, _front{2} {}
+
+    RaTripleBuffer(const RaTripleBuffer&) = delete;
+    RaTripleBuffer& operator=(const RaTripleBuffer&) = delete;
+
+    /**
+     * buffer the producer draws into, only call from the producer.
+     */
+    int back() const { return _back; }
+
+    /**
+     * hands the back buffer to the consumer, and takes a new back buffer.
+     */
+    void publish() {
+        _back = _middle.exchange(_back | Fresh, std::memory_order_acq_rel) & Index;
+    }
+
+    /**
+     * takes the latest published buffer as the front buffer, if there is
+     * one newer than the current front buffer.
+     *
+     * @returns true if front changed.
+     */
+    bool consume() {
+        if(!(_middle.load(std::memory_order_relaxed) & Fresh)) {
+            return false;
+        }
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & Index;
+        return true;
+    }
+
+    /**
+     * buffer the consumer reads, only call from the consumer.
+     */
+    int front() const { return _front; }
+
+private:
+    enum { Index = 3, Fresh = 4 };
+
+    std::atomic<int> _middle;
+    int _back;
+    int _front;
+};
+
+#endif /* SRC_RA_TRIPLE_BUFFER_HPP_ */
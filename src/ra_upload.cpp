@@ -0,0 +1,221 @@
+/*
+ * ra_upload.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include "ra_upload.hpp"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelStorage.h>
+#include <Magnum/GL/BufferImage.h>
+
+#include <cstring>
+
+using namespace Magnum;
+
+bool RaUpload_NativeFormat(uint32_t format, GL::PixelFormat &glFormat,
+        GL::PixelType &glType)
+{
+    switch(format) {
+        case RA_PIXEL_BGRA8:
+            glFormat = GL::PixelFormat::BGRA;
+            glType = GL::PixelType::UnsignedByte;
+            return true;
+        case RA_PIXEL_RGBA8:
+            glFormat = GL::PixelFormat::RGBA;
+            glType = GL::PixelType::UnsignedByte;
+            return true;
+        case RA_PIXEL_RGB8:
+            glFormat = GL::PixelFormat::RGB;
+            glType = GL::PixelType::UnsignedByte;
+            return true;
+        case RA_PIXEL_BGR8:
+            glFormat = GL::PixelFormat::BGR;
+            glType = GL::PixelType::UnsignedByte;
+            return true;
+        case RA_PIXEL_RGBA16:
+            glFormat = GL::PixelFormat::RGBA;
+            glType = GL::PixelType::UnsignedShort;
+            return true;
+        case RA_PIXEL_RGBAF32:
+            glFormat = GL::PixelFormat::RGBA;
+            glType = GL::PixelType::Float;
+            return true;
+        default:
+            // gray formats would land in the red channel only
+            return false;
+    }
+}
+
+RaPixelSource RaUpload_SurfaceSource(cairo_surface_t *surface)
+{
+    RaPixelSource src;
+    int stride = cairo_image_surface_get_stride(surface);
+    src.data = cairo_image_surface_get_data(surface);
+    src.size = (std::size_t)stride * cairo_image_surface_get_height(surface);
+    src.row_length = stride / 4;
+    src.pixel_size = 4;
+    src.format = GL::PixelFormat::BGRA;
+    src.type = GL::PixelType::UnsignedByte;
+    return src;
+}
+
+void RaUpload_Direct(GL::Texture2D &texture, const RaPixelSource &src,
+        const RaRect *rects, int count, RaUploadStats &stats, int level)
+{
+    Containers::ArrayView<const void> av{src.data, src.size};
+
+    for(int i = 0; i < count; ++i) {
+        const RaRect &r = rects[i];
+
+        // row length and skip tell GL where the rect lives in the source,
+        // so the rows are read in place without packing them first.
+        PixelStorage storage;
+        storage.setAlignment(1)
+            .setRowLength(src.row_length)
+            .setSkip({r.x - src.origin_x, r.y - src.origin_y, 0});
+
+        ImageView2D iv{storage, src.format, src.type, {r.w, r.h}, av};
+
+        texture.setSubImage(level, {r.x, r.y}, iv);
+
+        stats.uploads += 1;
+        stats.bytes += (uint64_t)r.area() * src.pixel_size;
+    }
+}
+
+void RaUpload_DirectLayer(GL::Texture2DArray &texture, int layer,
+        const RaPixelSource &src, const RaRect *rects, int count, RaUploadStats &stats)
+{
+    Containers::ArrayView<const void> av{src.data, src.size};
+
+    for(int i = 0; i < count; ++i) {
+        const RaRect &r = rects[i];
+
+        PixelStorage storage;
+        storage.setAlignment(1)
+            .setRowLength(src.row_length)
+            .setSkip({r.x - src.origin_x, r.y - src.origin_y, 0});
+
+        ImageView3D iv{storage, src.format, src.type, {r.w, r.h, 1}, av};
+
+        texture.setSubImage(0, {r.x, r.y, layer}, iv);
+
+        stats.uploads += 1;
+        stats.bytes += (uint64_t)r.area() * src.pixel_size;
+    }
+}
+
+RaUploadRing::RaUploadRing(int slots): _next{0}
+{
+    _slots.reserve(slots);
+    for(int i = 0; i < slots; ++i) {
+        _slots.push_back(Slot{GL::Buffer{GL::Buffer::TargetHint::PixelUnpack}, 0, RaFence{}});
+    }
+}
+
+/**
+ * each rect is packed tightly in the buffer, at an offset that is a whole
+ * number of its own rows, so it can be addressed with a row skip.
+ */
+static std::size_t packed_offset(std::size_t offset, std::size_t pitch)
+{
+    return (offset + pitch - 1) / pitch * pitch;
+}
+
+HRESULT RaUploadRing::upload(GL::Texture2D &texture, const RaPixelSource &src,
+        const RaRect *rects, int count, RaUploadStats &stats)
+{
+    if(count <= 0) {
+        return S_OK;
+    }
+
+    Slot &slot = _slots[_next];
+
+    // the GPU has not consumed this buffer yet, rather than block here,
+    // go through the driver's own copy.
+    if(!slot.fence.signaled()) {
+        stats.starved += 1;
+        RaUpload_Direct(texture, src, rects, count, stats);
+        return S_OK;
+    }
+
+    std::size_t total = 0;
+    for(int i = 0; i < count; ++i) {
+        std::size_t pitch = (std::size_t)rects[i].w * src.pixel_size;
+        total = packed_offset(total, pitch) + pitch * rects[i].h;
+    }
+
+    if(slot.size < total) {
+        slot.buffer.setData({nullptr, total}, GL::BufferUsage::StreamDraw);
+        slot.size = total;
+    }
+
+    // the fence guarantees the GPU is done with this buffer, so no need
+    // for the driver to synchronize the mapping.
+    Containers::ArrayView<char> dst = slot.buffer.map(0, total,
+            GL::Buffer::MapFlag::Write |
+            GL::Buffer::MapFlag::InvalidateBuffer |
+            GL::Buffer::MapFlag::Unsynchronized);
+
+    if(!dst.data()) {
+        RaUpload_Direct(texture, src, rects, count, stats);
+        return S_OK;
+    }
+
+    const char *srcData = static_cast<const char*>(src.data);
+    std::size_t srcPitch = (std::size_t)src.row_length * src.pixel_size;
+    std::vector<std::size_t> offsets(count);
+
+    std::size_t offset = 0;
+    for(int i = 0; i < count; ++i) {
+        const RaRect &r = rects[i];
+        std::size_t pitch = (std::size_t)r.w * src.pixel_size;
+        offset = packed_offset(offset, pitch);
+        offsets[i] = offset;
+
+        const char *row = srcData + (std::size_t)(r.y - src.origin_y) * srcPitch +
+            (std::size_t)(r.x - src.origin_x) * src.pixel_size;
+        for(int y = 0; y < r.h; ++y) {
+            std::memcpy(dst.data() + offset, row, pitch);
+            offset += pitch;
+            row += srcPitch;
+        }
+    }
+
+    // buffer contents are undefined if unmapping fails, i.e. the
+    // context lost video memory while it was mapped.
+    if(!slot.buffer.unmap()) {
+        RaUpload_Direct(texture, src, rects, count, stats);
+        return S_OK;
+    }
+
+    for(int i = 0; i < count; ++i) {
+        const RaRect &r = rects[i];
+        std::size_t pitch = (std::size_t)r.w * src.pixel_size;
+
+        PixelStorage storage;
+        storage.setAlignment(1)
+            .setSkip({0, (Int)(offsets[i] / pitch), 0});
+
+        // lend the buffer to a buffer image for the transfer, and take it back
+        GL::BufferImage2D image{storage, src.format, src.type, {r.w, r.h},
+            std::move(slot.buffer), total};
+
+        texture.setSubImage(0, {r.x, r.y}, image);
+
+        slot.buffer = image.release();
+
+        stats.uploads += 1;
+        stats.bytes += (uint64_t)r.area() * src.pixel_size;
+    }
+
+    slot.fence.insert();
+
+    _next = (_next + 1) % (int)_slots.size();
+
+    return S_OK;
+}
@@ -0,0 +1,116 @@
+/*
+ * ra_upload.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#ifndef SRC_RA_UPLOAD_HPP_
+#define SRC_RA_UPLOAD_HPP_
+
+#include <ra_upload.h>
+#include "ra_damage.hpp"
+#include "ra_fence.hpp"
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureArray.h>
+
+#include <cairo.h>
+#include <vector>
+
+/**
+ * describes pixels in client memory to copy to a texture.
+ *
+ * Rects are given in texture coordinates, the source data starts at
+ * the origin in the texture.
+ */
+struct RaPixelSource {
+    const void *data;
+
+    /**
+     * total size of data in bytes
+     */
+    std::size_t size;
+
+    /**
+     * pixels per row in memory, may be larger than the image width
+     */
+    int row_length;
+
+    /**
+     * bytes per pixel
+     */
+    int pixel_size;
+
+    Magnum::GL::PixelFormat format;
+    Magnum::GL::PixelType type;
+
+    /**
+     * texture position of the first pixel of data
+     */
+    int origin_x = 0;
+    int origin_y = 0;
+};
+
+/**
+ * Gets the GL pixel format and type for a RaPixelFormat that GL can upload
+ * without conversion.
+ *
+ * @returns false if the format needs converting on the CPU first.
+ */
+bool RaUpload_NativeFormat(uint32_t format, Magnum::GL::PixelFormat &glFormat,
+        Magnum::GL::PixelType &glType);
+
+/**
+ * describes the pixels of a cairo image surface, BGRA with premultiplied
+ * alpha.
+ */
+RaPixelSource RaUpload_SurfaceSource(cairo_surface_t *surface);
+
+/**
+ * copies rects of the source to a mip level of the texture, straight from
+ * client memory.
+ */
+void RaUpload_Direct(Magnum::GL::Texture2D &texture, const RaPixelSource &src,
+        const RaRect *rects, int count, RaUploadStats &stats, int level = 0);
+
+/**
+ * copies rects of the source to a layer of a texture array, straight from
+ * client memory.
+ */
+void RaUpload_DirectLayer(Magnum::GL::Texture2DArray &texture, int layer,
+        const RaPixelSource &src, const RaRect *rects, int count, RaUploadStats &stats);
+
+/**
+ * Ring of pixel-unpack buffers for asynchronous texture uploads.
+ *
+ * Each upload copies the source rects into the next buffer in the ring,
+ * and the transfer to the texture happens from the buffer, so the upload
+ * call returns without waiting for the texture to be free. A fence is
+ * inserted after each transfer, and a buffer is only reused once its fence
+ * is signaled. If the next buffer is still in use, the ring is starved and
+ * the upload falls back to a direct upload.
+ */
+class RaUploadRing {
+public:
+    explicit RaUploadRing(int slots);
+
+    HRESULT upload(Magnum::GL::Texture2D &texture, const RaPixelSource &src,
+            const RaRect *rects, int count, RaUploadStats &stats);
+
+    int slots() const { return (int)_slots.size(); }
+
+private:
+    struct Slot {
+        Magnum::GL::Buffer buffer;
+        std::size_t size;
+        RaFence fence;
+    };
+
+    std::vector<Slot> _slots;
+    int _next;
+};
+
+#endif /* SRC_RA_UPLOAD_HPP_ */
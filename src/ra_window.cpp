@@ -6,18 +6,176 @@
  */
 
 #include "ra_window.hpp"
+#include "ra_canvas.hpp"
+#include "ra_canvas_batch.hpp"
+#include "ra_atlas.hpp"
+#include "ra_capture.hpp"
+#include "ra_gl_registry.hpp"
 #include <carbon.h>
 
+#include <Magnum/ImageView.h>
+#include <Magnum/GL/DefaultFramebuffer.h>
+#include <Magnum/GL/PixelFormat.h>
+
+#include <glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace Magnum;
 
 
 RaWindow* RaWindow::New(struct GLFWwindow *win)
 {
     RaWindow *result = new RaWindow();
     result->window = win;
+    result->framebuffer = &GL::defaultFramebuffer;
+    result->width = 0;
+    result->height = 0;
+    result->canvas = NULL;
+    result->read_stats = {};
+    result->drawing = false;
+    result->capture = NULL;
+    return result;
+}
+
+RaWindow* RaWindow::NewHeadless(GL::AbstractFramebuffer *framebuffer, int width, int height)
+{
+    RaWindow *result = new RaWindow();
+    result->window = NULL;
+    result->framebuffer = framebuffer;
+    result->width = width;
+    result->height = height;
     result->canvas = NULL;
+    result->read_stats = {};
+    result->drawing = false;
+    result->capture = NULL;
+    return result;
+}
+
+void RaWindow::framebufferSize(int &w, int &h) const
+{
+    if(window) {
+        glfwGetFramebufferSize(window, &w, &h);
+    }
+    else {
+        w = width;
+        h = height;
+    }
+}
+
+void RaWindow::draw()
+{
+    RaGlState &state = RaGlRegistry::current().state();
+
+    drawing = true;
+
+    // reads from the last frames are usually done by now
+    if(readback) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        readback->poll(false, read_stats);
+
+        // most of the reads are frames of the capture
+        if(capture) {
+            capture->addTime(std::chrono::steady_clock::now() - start);
+        }
+
+        // the read callbacks are user code
+        state.invalidate();
+    }
+
+    if(canvas) {
+        canvas->draw();
+    }
+
+    for(RaCanvasBatch *batch : batches) {
+        batch->draw();
+    }
+
+    for(RaAtlas *atlas : atlases) {
+        atlas->draw();
+    }
+
+    // blending is only enabled while radium draws
+    state.setBlending(false);
+
+    // the frame is complete, and not swapped yet
+    std::vector<DeferredRead> reads;
+    reads.swap(deferred_reads);
+    for(const DeferredRead &read : reads) {
+        readback->read(*framebuffer, read.rect, read.format, read.data,
+                read.callback, read.user_data, read_stats);
+    }
+
+    if(capture) {
+        capture->frame();
+    }
+
+    drawing = false;
+}
+
+std::vector<RaWindow::DeferredRead> RaWindow::cancelReads(
+        const std::function<bool(const DeferredRead&)> &match)
+{
+    std::vector<DeferredRead> result;
+    std::vector<DeferredRead> kept;
+
+    for(const DeferredRead &read : deferred_reads) {
+        (match(read) ? result : kept).push_back(read);
+    }
+
+    deferred_reads.swap(kept);
     return result;
 }
 
+CAPI_FUNC(HRESULT) RaWindow_ReadPixels(RaWindow *window, int x, int y, int width, int height,
+        uint32_t format, void *data)
+{
+    if(!window || !data) {
+        return c_error(E_INVALIDARG, "window or data is NULL");
+    }
+
+    if(format != RA_PIXEL_BGRA8 && format != RA_PIXEL_RGBA8) {
+        return c_error(E_INVALIDARG, "only BGRA8 and RGBA8 can be read");
+    }
+
+    // once swapped, the back buffer of a GLFW window is undefined
+    if(window->window && !window->drawing) {
+        return c_error(E_FAIL, "a GLFW window can only be read while it is drawn, "
+                "use RaWindow_ReadPixelsAsync, or a headless application");
+    }
+
+    int fbWidth, fbHeight;
+    window->framebufferSize(fbWidth, fbHeight);
+
+    if(x < 0 || y < 0 || width <= 0 || height <= 0 ||
+       x + width > fbWidth || y + height > fbHeight) {
+        return c_error(E_INVALIDARG, "region is outside of the framebuffer");
+    }
+
+    const std::size_t rowSize = (std::size_t)width * 4;
+
+    // GL rows go bottom up
+    window->framebuffer->read({{x, fbHeight - y - height}, {x + width, fbHeight - y}},
+        MutableImageView2D{
+            format == RA_PIXEL_BGRA8 ? GL::PixelFormat::BGRA : GL::PixelFormat::RGBA,
+            GL::PixelType::UnsignedByte, {width, height},
+            {data, rowSize * height}});
+
+    char *rows = static_cast<char*>(data);
+    std::vector<char> tmp(rowSize);
+    for(int i = 0; i < height / 2; ++i) {
+        char *a = rows + i * rowSize;
+        char *b = rows + (height - 1 - i) * rowSize;
+        std::copy(a, a + rowSize, tmp.data());
+        std::copy(b, b + rowSize, a);
+        std::copy(tmp.data(), tmp.data() + rowSize, b);
+    }
+
+    return S_OK;
+}
+
 CAPI_FUNC(HRESULT) RaWindow_DestroyWindow(RaWindow *window)
 {
     return c_error(E_NOTIMPL, "not implemented");
@@ -72,10 +230,103 @@ CAPI_FUNC(HRESULT) RaWindow_SetWindowSize(RaWindow *window, int width,
     return c_error(E_NOTIMPL, "not implemented");
 }
 
+CAPI_FUNC(HRESULT) RaWindow_ReadPixelsAsync(RaWindow *window, int x, int y, int width, int height,
+        uint32_t format, void *data, RaFenceCallback callback, void *user_data)
+{
+    if(!window || !data) {
+        return c_error(E_INVALIDARG, "window or data is NULL");
+    }
+
+    if(format != RA_PIXEL_BGRA8 && format != RA_PIXEL_RGBA8) {
+        return c_error(E_INVALIDARG, "only BGRA8 and RGBA8 can be read");
+    }
+
+    int fbWidth, fbHeight;
+    window->framebufferSize(fbWidth, fbHeight);
+
+    if(x < 0 || y < 0 || width <= 0 || height <= 0 ||
+       x + width > fbWidth || y + height > fbHeight) {
+        return c_error(E_INVALIDARG, "region is outside of the framebuffer");
+    }
+
+    if(!window->readback) {
+        window->readback.reset(new RaReadbackRing(RaReadbackRing::DefaultSlots));
+    }
+
+    RaRect rect = {x, fbHeight - y - height, width, height};
+
+    // between frames, the back buffer of a GLFW window is undefined
+    if(window->window && !window->drawing) {
+        window->deferred_reads.push_back({rect, format, data, callback, user_data});
+        if(window->redraw) {
+            window->redraw();
+        }
+        return S_OK;
+    }
+
+    return window->readback->read(*window->framebuffer, rect, format, data,
+            callback, user_data, window->read_stats);
+}
+
+CAPI_FUNC(int) RaWindow_PollReadPixels(RaWindow *window, int wait)
+{
+    if(!window) {
+        c_error(E_INVALIDARG, "window is NULL");
+        return -1;
+    }
+
+    if(!window->readback) {
+        return 0;
+    }
+
+    // reads waiting for the next frame are issued by drawing it now, if
+    // that can not be done, they are not waited on
+    if(wait && !window->deferred_reads.empty() && !window->drawing && window->drawNow) {
+        window->drawNow();
+    }
+
+    return window->readback->poll(wait != 0, window->read_stats) +
+            (int)window->deferred_reads.size();
+}
+
+CAPI_FUNC(HRESULT) RaWindow_SetReadBuffers(RaWindow *window, int count)
+{
+    if(!window || count <= 0) {
+        return c_error(E_INVALIDARG, "invalid window or read buffer count");
+    }
+
+    if(window->readback && window->readback->slots() == count) {
+        return S_OK;
+    }
+
+    // reads in flight still go to their callers
+    if(window->readback) {
+        window->readback->poll(true, window->read_stats);
+    }
+
+    window->readback.reset(new RaReadbackRing(count));
+    return S_OK;
+}
+
+CAPI_FUNC(HRESULT) RaWindow_GetReadStats(RaWindow *window, RaReadStats *stats)
+{
+    if(!window || !stats) {
+        return c_error(E_INVALIDARG, "window or stats is NULL");
+    }
+
+    *stats = window->read_stats;
+    return S_OK;
+}
+
 CAPI_FUNC(HRESULT) RaWindow_GetFramebufferSize(RaWindow *window, int *width,
         int *height)
 {
-    return c_error(E_NOTIMPL, "not implemented");
+    if(!window || !width || !height) {
+        return c_error(E_INVALIDARG, "window, width or height is NULL");
+    }
+
+    window->framebufferSize(*width, *height);
+    return S_OK;
 }
 
 CAPI_FUNC(HRESULT) RaWindow_GetWindowFrameSize(RaWindow *window, int *left,
@@ -10,13 +10,110 @@
 
 
 #include <ra_window.h>
+#include "ra_readback.hpp"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Magnum { namespace GL { class AbstractFramebuffer; } }
 
 struct RaWindow {
+    /**
+     * the GLFW window, NULL for the window of a headless application.
+     */
     struct GLFWwindow *window;
 
+    /**
+     * framebuffer the window's content is drawn into and read back from,
+     * the default framebuffer, or an offscreen one if headless.
+     */
+    Magnum::GL::AbstractFramebuffer *framebuffer;
+
+    /**
+     * framebuffer size of a headless window, GLFW windows ask GLFW.
+     */
+    int width;
+    int height;
+
     struct RaCanvas *canvas;
 
+    /**
+     * canvas batches, drawn after the canvas in the order they were created
+     */
+    std::vector<struct RaCanvasBatch*> batches;
+
+    /**
+     * texture atlases, drawn after the batches
+     */
+    std::vector<struct RaAtlas*> atlases;
+
+    /**
+     * pixel-pack buffers of RaWindow_ReadPixelsAsync, created on first use.
+     */
+    std::unique_ptr<RaReadbackRing> readback;
+
+    RaReadStats read_stats;
+
+    /**
+     * an async read of a GLFW window asked for between frames.
+     */
+    struct DeferredRead {
+        RaRect rect;
+        uint32_t format;
+        void *data;
+        RaFenceCallback callback;
+        void *user_data;
+    };
+
+    /**
+     * reads of a GLFW window asked for between frames, its back buffer is
+     * undefined once swapped, so they are queued at the end of the next
+     * draw, before the swap.
+     */
+    std::vector<DeferredRead> deferred_reads;
+
+    /**
+     * set while draw runs, the only time the back buffer of a GLFW window
+     * holds the frame.
+     */
+    bool drawing;
+
+    /**
+     * set by the GLFW application, which only draws when asked: redraw
+     * asks for the next frame, so deferred reads are issued, and drawNow
+     * draws and swaps a frame right away, for deferred reads waited on.
+     */
+    std::function<void()> redraw;
+    std::function<void()> drawNow;
+
+    /**
+     * capture recording the frames drawn, NULL if none.
+     */
+    struct RaCapture *capture;
+
     static RaWindow *New(struct GLFWwindow *win);
+
+    /**
+     * window with no GLFW window, that draws into an offscreen framebuffer
+     * of the given size.
+     */
+    static RaWindow *NewHeadless(Magnum::GL::AbstractFramebuffer *framebuffer,
+            int width, int height);
+
+    void framebufferSize(int &width, int &height) const;
+
+    /**
+     * draws the canvas, batches and atlases into the bound framebuffer,
+     * then captures the frame if it is being recorded.
+     */
+    void draw();
+
+    /**
+     * drops the deferred reads that match, they are never delivered.
+     *
+     * @returns the dropped reads, so their owners can free them.
+     */
+    std::vector<DeferredRead> cancelReads(const std::function<bool(const DeferredRead&)> &match);
 };
 
 #endif /* INCLUDE_RA_WINDOW_H_ */
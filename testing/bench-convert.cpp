@@ -0,0 +1,228 @@
+/*
+ * bench-convert.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include <radium.h>
+
+#include "ra_pixel_convert.hpp"
+#include "ra_simd.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * a 1080p frame, large enough to be out of cache, as a video frame is.
+ */
+static const std::size_t Pixels = 1920 * 1080;
+
+static const int Repeats = 20;
+
+/**
+ * best time of Repeats conversions of the frame, in seconds.
+ */
+static double time_converter(RaPixelConverter convert, const void *src, void *dst)
+{
+    double best = 1e9;
+    for(int i = 0; i < Repeats; ++i) {
+        Clock::time_point start = Clock::now();
+        convert(src, dst, Pixels);
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+/**
+ * times the dispatched converter against the scalar one, and checks they
+ * give the same bytes.
+ *
+ * @returns false if they differ
+ */
+static bool bench(const char *name, RaPixelConverter fast, RaPixelConverter scalar,
+        const std::vector<uint8_t> &src, int dstSize)
+{
+    std::vector<uint8_t> fastOut(Pixels * dstSize), scalarOut(Pixels * dstSize);
+
+    const double fastTime = time_converter(fast, src.data(), fastOut.data());
+    const double scalarTime = time_converter(scalar, src.data(), scalarOut.data());
+
+    const bool same = fastOut == scalarOut;
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-24s scalar %8.1f Mpix/s   dispatched %8.1f Mpix/s   %5.2fx%s",
+            name, Pixels / scalarTime / 1e6, Pixels / fastTime / 1e6, scalarTime / fastTime,
+            same ? "" : "   MISMATCH");
+    std::cout << line << std::endl;
+
+    return same;
+}
+
+/**
+ * what callers had to do before RaApplication_SetImage took a format:
+ * convert the frame to BGRA8 themselves, a pixel at a time.
+ */
+static void caller_to_bgra8(uint32_t format, const uint8_t *src, uint8_t *dst)
+{
+    if(RaPixelConverter convert = RaPixelConvert_ToBGRA8Scalar(format)) {
+        convert(src, dst, Pixels);
+        return;
+    }
+
+    for(std::size_t i = 0; i < Pixels; ++i, dst += 4) {
+        switch(format) {
+            case RA_PIXEL_RGB8:
+                dst[0] = src[2]; dst[1] = src[1]; dst[2] = src[0]; dst[3] = 255;
+                src += 3;
+                break;
+            case RA_PIXEL_BGR8:
+                dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = 255;
+                src += 3;
+                break;
+            case RA_PIXEL_RGBA8:
+                dst[0] = src[2]; dst[1] = src[1]; dst[2] = src[0]; dst[3] = src[3];
+                src += 4;
+                break;
+            case RA_PIXEL_RGBA16:
+                // little endian, the high byte of each channel
+                dst[0] = src[5]; dst[1] = src[3]; dst[2] = src[1]; dst[3] = src[7];
+                src += 8;
+                break;
+            case RA_PIXEL_RGBAF32: {
+                float c[4];
+                std::memcpy(c, src, 16);
+                for(int k = 0; k < 4; ++k) {
+                    c[k] = std::min(1.f, std::max(0.f, c[k])) * 255.f + 0.5f;
+                }
+                dst[0] = (uint8_t)c[2]; dst[1] = (uint8_t)c[1];
+                dst[2] = (uint8_t)c[0]; dst[3] = (uint8_t)c[3];
+                src += 16;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * best time of Repeats calls of RaApplication_SetImage with the frame, in
+ * seconds. If bgra is not NULL, the frame is first converted into it the
+ * way callers used to, and uploaded as BGRA8, otherwise it is uploaded in
+ * its own format.
+ */
+static double time_upload(RaApplication *app, uint32_t format, const std::vector<uint8_t> &src,
+        std::vector<uint8_t> *bgra)
+{
+    double best = 1e9;
+    for(int i = 0; i < Repeats; ++i) {
+        Clock::time_point start = Clock::now();
+        if(bgra) {
+            caller_to_bgra8(format, src.data(), bgra->data());
+            RaApplication_SetImage(app, 1920, 1080, RA_PIXEL_BGRA8, bgra->data());
+        }
+        else {
+            RaApplication_SetImage(app, 1920, 1080, format, src.data());
+        }
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+/**
+ * Time the render thread spends in RaApplication_SetImage for a 1080p
+ * frame in each format, against converting it to BGRA8 first, the only
+ * format SetImage used to take. Native formats go to GL as they are, the
+ * others through the dispatched converters. GL may finish the upload
+ * later, this is the cost to the caller.
+ */
+static void bench_upload(int argc, const char **argv, const std::vector<uint8_t> &src,
+        const std::vector<uint8_t> &floats)
+{
+    RaApplication *app = RaApplication_CreateHeadless(argc, argv, 64, 64);
+
+    std::vector<uint8_t> bgra(Pixels * 4);
+
+    const struct {
+        const char *name;
+        uint32_t format;
+    } formats[] = {
+        {"rgba8", RA_PIXEL_RGBA8},
+        {"rgb8", RA_PIXEL_RGB8},
+        {"bgr8", RA_PIXEL_BGR8},
+        {"rgba16", RA_PIXEL_RGBA16},
+        {"rgbaf32", RA_PIXEL_RGBAF32},
+        {"gray8", RA_PIXEL_GRAY8},
+        {"gray16", RA_PIXEL_GRAY16},
+        {"grayf32", RA_PIXEL_GRAYF32},
+    };
+
+    for(const auto &f : formats) {
+        const std::vector<uint8_t> &data =
+                f.format == RA_PIXEL_GRAYF32 || f.format == RA_PIXEL_RGBAF32 ? floats : src;
+
+        const double bgraTime = time_upload(app, f.format, data, &bgra);
+        const double ownTime = time_upload(app, f.format, data, NULL);
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "upload %-17s as bgra8 %8.2f ms   as %-8s %8.2f ms   %5.2fx",
+                f.name, bgraTime * 1e3, f.name, ownTime * 1e3, bgraTime / ownTime);
+        std::cout << line << std::endl;
+    }
+}
+
+/**
+ * Throughput of the pixel format converters, the SIMD code this CPU gets
+ * against the scalar code, on a 1080p frame, then the cost of uploading
+ * a frame in each format against converting it to BGRA8 first. Set
+ * RADIUM_SIMD to mask the instruction sets, i.e. RADIUM_SIMD=0 for scalar
+ * only.
+ */
+int bench_convert(int argc, const char **argv)
+{
+    std::cout << "simd features: "
+              << (RaSimd_Supports(RA_SIMD_SSE2) ? "sse2 " : "")
+              << (RaSimd_Supports(RA_SIMD_SSSE3) ? "ssse3 " : "")
+              << (RaSimd_Supports(RA_SIMD_SSE42) ? "sse4.2 " : "")
+              << (RaSimd_Supports(RA_SIMD_AVX2) ? "avx2 " : "") << std::endl;
+
+    // enough for the widest source, RGBAF32
+    std::vector<uint8_t> src(Pixels * 16);
+    uint32_t seed = 12345;
+    for(uint8_t &byte : src) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = (uint8_t)(seed >> 24);
+    }
+
+    // floats in 0 to 1, with some out of range to hit the clamping,
+    // enough for RGBAF32
+    std::vector<uint8_t> floats(Pixels * 16);
+    for(std::size_t i = 0; i < Pixels * 4; ++i) {
+        float f = (float)(i % 1031) / 1000.f - 0.01f;
+        std::memcpy(&floats[4 * i], &f, 4);
+    }
+
+    bool ok = true;
+
+    ok &= bench("gray8 to bgra8", RaPixelConvert_ToBGRA8(RA_PIXEL_GRAY8),
+            RaPixelConvert_ToBGRA8Scalar(RA_PIXEL_GRAY8), src, 4);
+    ok &= bench("gray16 to bgra8", RaPixelConvert_ToBGRA8(RA_PIXEL_GRAY16),
+            RaPixelConvert_ToBGRA8Scalar(RA_PIXEL_GRAY16), src, 4);
+    ok &= bench("grayf32 to bgra8", RaPixelConvert_ToBGRA8(RA_PIXEL_GRAYF32),
+            RaPixelConvert_ToBGRA8Scalar(RA_PIXEL_GRAYF32), floats, 4);
+    ok &= bench("unpremultiply", RaPixelConvert_Unpremultiply(),
+            RaPixelConvert_UnpremultiplyScalar(), src, 4);
+    ok &= bench("bgra8 to rgb8", RaPixelConvert_ToRGB8(RA_PIXEL_BGRA8),
+            RaPixelConvert_ToRGB8Scalar(RA_PIXEL_BGRA8), src, 3);
+    ok &= bench("rgba8 to rgb8", RaPixelConvert_ToRGB8(RA_PIXEL_RGBA8),
+            RaPixelConvert_ToRGB8Scalar(RA_PIXEL_RGBA8), src, 3);
+
+    bench_upload(argc, argv, src, floats);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+/*
+ * bench-shaders.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include <radium.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * creates a headless application, and the canvas, batch and YUV image
+ * that build all the shader programs, and draws a frame.
+ *
+ * @returns the wall time, in milliseconds.
+ */
+static double launch(int argc, const char **argv)
+{
+    Clock::time_point start = Clock::now();
+
+    RaApplication *app = RaApplication_CreateHeadless(argc, argv, 256, 256);
+    RaWindow *win = RaApplication_GetWindow(app, 0);
+
+    RaCanvas_CreateForWindow(win);
+    RaCanvasBatch_Create(win, 64, 64);
+
+    std::vector<uint8_t> nv12(16 * 16 * 3 / 2, 128);
+    RaApplication_SetImage(app, 16, 16, RA_PIXEL_NV12, nv12.data());
+
+    RaApplication_DrawFrame(app);
+
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void print(const char *name, double ms, const RaProgramCacheStats &before)
+{
+    RaProgramCacheStats after;
+    RaProgramCache_GetStats(&after);
+
+    std::cout << name << ": " << ms << " ms, "
+              << after.hits - before.hits << " loaded in "
+              << (after.load_ns - before.load_ns) / 1e6 << " ms, "
+              << after.misses - before.misses << " compiled in "
+              << (after.compile_ns - before.compile_ns) / 1e6 << " ms, "
+              << after.rejected - before.rejected << " rejected" << std::endl;
+}
+
+/**
+ * Startup cost of the shader programs, with and without the program
+ * cache. The cache is cleared, and an application is launched, which
+ * compiles every program from source, then a second one is launched, in
+ * its own GL context, which loads them from the cache.
+ *
+ * The driver may keep its own cache of compiled shaders, i.e. Mesa's, so
+ * for the true cold time also clear that, or set MESA_SHADER_CACHE_DISABLE.
+ */
+int bench_shaders(int argc, const char **argv)
+{
+    RaProgramCache_Clear();
+
+    RaProgramCacheStats start, cold;
+
+    RaProgramCache_GetStats(&start);
+    double ms = launch(argc, argv);
+    print("cold launch", ms, start);
+
+    RaProgramCache_GetStats(&cold);
+    ms = launch(argc, argv);
+    print("warm launch", ms, cold);
+
+    RaProgramCacheStats warm;
+    RaProgramCache_GetStats(&warm);
+
+    if(cold.stored == start.stored) {
+        std::cout << "the program cache is disabled, or the driver has no program binaries"
+                  << std::endl;
+        return 0;
+    }
+
+    // everything the cold launch saved should have been loaded
+    return warm.misses == cold.misses ? 0 : 1;
+}
@@ -4,6 +4,9 @@
 
 #include <radium.h>
 #include <cmath>
+#include <cstring>
+
+#include <Corrade/Utility/Resource.h>
 
 #define _USE_MATH_DEFINES // for C
 #include <math.h>
@@ -12,7 +15,31 @@ void cairo_test(RaApplication *app);
 
 void foo();
 
+int bench_convert(int argc, const char **argv);
+
+int bench_shaders(int argc, const char **argv);
+
+int test_texture_file();
+
 int main(int argc, const char** argv) {
+  // the shaders are compiled into the static library, which the linker
+  // drops unless something refers to them
+  CORRADE_RESOURCE_INITIALIZE(TexturedTriangle_RESOURCES)
+
+  // benchmarks and tests, run instead of the demo, they return non-zero
+  // on failure
+  if(argc > 1 && std::strcmp(argv[1], "--bench-convert") == 0) {
+    return bench_convert(1, argv);
+  }
+
+  if(argc > 1 && std::strcmp(argv[1], "--bench-shaders") == 0) {
+    return bench_shaders(1, argv);
+  }
+
+  if(argc > 1 && std::strcmp(argv[1], "--test-texture-file") == 0) {
+    return test_texture_file();
+  }
+
   const char* cairo_ver = cairo_version_string ();
   std::cout << "cairo version: " << cairo_ver << std::endl;
 
@@ -0,0 +1,149 @@
+/*
+ * test-texture-file.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ */
+
+#include <radium.h>
+
+#include "ra_texture_file.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+static int checks = 0;
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    checks += 1;
+    if(!ok) {
+        failures += 1;
+        std::cout << "FAILED: " << what << std::endl;
+    }
+}
+
+static std::vector<uint8_t> read_file(const char *path)
+{
+    std::vector<uint8_t> result;
+    if(std::FILE *file = std::fopen(path, "rb")) {
+        uint8_t buf[4096];
+        std::size_t n;
+        while((n = std::fread(buf, 1, sizeof(buf), file)) > 0) {
+            result.insert(result.end(), buf, buf + n);
+        }
+        std::fclose(file);
+    }
+    return result;
+}
+
+static void put32(std::vector<uint8_t> &data, std::size_t at, uint32_t value)
+{
+    for(int i = 0; i < 4; ++i) {
+        data[at + i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static bool parses(const std::vector<uint8_t> &data, std::size_t size)
+{
+    RaTextureFile file;
+    return SUCCEEDED(RaTextureFile_Parse(data.data(), size, file));
+}
+
+/**
+ * writes and parses back an odd sized image, checks the level sizes,
+ * alignment and swizzle, then damages the file in the ways a bad file on
+ * disk would be, and checks that each is rejected.
+ */
+int test_texture_file()
+{
+    const char *path = "ra-test-texture.rtex";
+    const int width = 37, height = 23;
+
+    std::vector<uint8_t> rgba(width * height * 4);
+    for(std::size_t i = 0; i < rgba.size(); ++i) {
+        rgba[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    for(uint32_t format : {RA_PIXEL_BGRA8, RA_PIXEL_RGBA8}) {
+        check(SUCCEEDED(RaTextureFile_Write(path, format, width, height, rgba.data(), 0, true)),
+              "write");
+
+        std::vector<uint8_t> data = read_file(path);
+        RaTextureFile file;
+        check(SUCCEEDED(RaTextureFile_Parse(data.data(), data.size(), file)), "parse");
+
+        // 37 x 23 down to 1 x 1
+        check(file.format == format && file.width == width && file.height == height,
+              "header");
+        check(file.levels.size() == 6, "level count");
+
+        for(std::size_t l = 0; l < file.levels.size(); ++l) {
+            const RaTextureLevel &level = file.levels[l];
+            check(level.width == std::max(1, width >> l) &&
+                  level.height == std::max(1, height >> l), "level size");
+            check((level.data - data.data()) % 4096 == 0, "level alignment");
+        }
+
+        if(file.levels.empty()) {
+            continue;
+        }
+
+        bool same = true;
+        const uint8_t *stored = file.levels[0].data;
+        for(int i = 0; i < width * height; ++i) {
+            const uint8_t *in = &rgba[4 * i], *out = &stored[4 * i];
+            if(format == RA_PIXEL_BGRA8) {
+                same &= out[0] == in[2] && out[1] == in[1] && out[2] == in[0] && out[3] == in[3];
+            }
+            else {
+                same &= std::memcmp(in, out, 4) == 0;
+            }
+        }
+        check(same, "level 0 pixels");
+
+        // every level ends exactly at the end of the file, any shorter
+        // file is missing pixels
+        for(std::size_t size : {std::size_t(0), std::size_t(3), std::size_t(31),
+                std::size_t(32 + 6 * 16 - 1), std::size_t(4096), data.size() - 1}) {
+            check(!parses(data, size), "truncated file");
+        }
+
+        std::vector<uint8_t> bad = data;
+        put32(bad, 32 + 16, 4096 + 4);
+        check(!parses(bad, bad.size()), "misaligned level");
+
+        bad = data;
+        put32(bad, 32 + 16, 0);
+        check(!parses(bad, bad.size()), "level over the header");
+
+        bad = data;
+        put32(bad, 12, 0x10000);
+        check(!parses(bad, bad.size()), "oversized width");
+
+        bad = data;
+        put32(bad, 16, 0);
+        check(!parses(bad, bad.size()), "zero height");
+
+        bad = data;
+        put32(bad, 20, 7);
+        check(!parses(bad, bad.size()), "more levels than the size has");
+
+        bad = data;
+        put32(bad, 32 + 8, width + 1);
+        check(!parses(bad, bad.size()), "wrong level size");
+    }
+
+    check(FAILED(RaTextureFile_Write(path, RA_PIXEL_BGRA8, 0x10000, 1, rgba.data(), 0, false)),
+          "write oversized");
+
+    std::remove(path);
+
+    std::cout << "texture file: " << checks << " checks, " << failures << " failed" << std::endl;
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * ra-texconv.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: andy
+ *
+ * Converts TGA and JPEG images to radium texture files, that load with
+ * RaAsset_Load straight from the mapped file, with no decoding.
+ *
+ *     ra-texconv [--mipmaps] [--rgba] input.tga|input.jpg output.rtex
+ */
+
+#include "ra_decode.hpp"
+#include "ra_mapped_file.hpp"
+#include "ra_texture_file.hpp"
+#include <ra_upload.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static int usage()
+{
+    std::fprintf(stderr,
+        "usage: ra-texconv [--mipmaps] [--rgba] input output.rtex\n"
+        "\n"
+        "  --mipmaps  store a full mip chain\n"
+        "  --rgba     store RGBA8 pixels, the default is BGRA8, which desktop\n"
+        "             GL drivers upload without swizzling\n");
+    return 2;
+}
+
+int main(int argc, const char **argv)
+{
+    bool mipmaps = false;
+    uint32_t format = RA_PIXEL_BGRA8;
+    const char *paths[2] = {NULL, NULL};
+    int count = 0;
+
+    for(int i = 1; i < argc; ++i) {
+        if(std::strcmp(argv[i], "--mipmaps") == 0) {
+            mipmaps = true;
+        }
+        else if(std::strcmp(argv[i], "--rgba") == 0) {
+            format = RA_PIXEL_RGBA8;
+        }
+        else if(argv[i][0] == '-' || count == 2) {
+            return usage();
+        }
+        else {
+            paths[count++] = argv[i];
+        }
+    }
+
+    if(count != 2) {
+        return usage();
+    }
+
+    RaMappedFile input;
+    if(FAILED(input.open(paths[0]))) {
+        std::fprintf(stderr, "ra-texconv: could not open %s\n", paths[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> pixels;
+    int width, height;
+    if(!RaDecode_Image(input.data(), input.size(), pixels, width, height)) {
+        std::fprintf(stderr, "ra-texconv: could not decode %s\n", paths[0]);
+        return 1;
+    }
+
+    if(FAILED(RaTextureFile_Write(paths[1], format, width, height, pixels.data(), 0, mipmaps))) {
+        std::fprintf(stderr, "ra-texconv: could not write %s\n", paths[1]);
+        return 1;
+    }
+
+    return 0;
+}